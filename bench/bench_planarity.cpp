@@ -0,0 +1,112 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2017, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+//-- microbenchmark: the planarity tests of validate_2d_primitives() on an 
+//-- n x n grid of quads (each triangulated in 2 triangles), with the scalar
+//-- pre-filters (flag_faces_distance2plane() and flag_faces_normals()) vs 
+//-- the CGAL tests for each face
+//--
+//-- build with: cmake -DVAL3DITY_BENCHMARKS=ON ..
+//-- run with:   ./bench_planarity [n] [repetitions]
+
+#include "geomtools.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace val3dity;
+
+int main(int argc, char* argv[])
+{
+  int n = (argc > 1) ? std::atoi(argv[1]) : 1000;
+  int repetitions = (argc > 2) ? std::atoi(argv[2]) : 5;
+  //-- the surface, stored like in Surface: one ring per face
+  std::vector<Point3> lsPts;
+  for (int i = 0; i <= n; i++)
+    for (int j = 0; j <= n; j++)
+      lsPts.push_back(Point3(i, j, 0.001 * ((i * 7 + j * 13) % 10)));
+  std::vector<int> ids, ringoffsets(1, 0), faceoffsets(1, 0), lsTrOffsets(1, 0);
+  std::vector<TriangleIds> lsTr;
+  for (int i = 0; i < n; i++)
+  {
+    for (int j = 0; j < n; j++)
+    {
+      int a = (i * (n + 1)) + j;
+      int b = a + n + 1;
+      for (int v : {a, b, b + 1, a + 1})
+        ids.push_back(v);
+      ringoffsets.push_back(ids.size());
+      faceoffsets.push_back(faceoffsets.back() + 1);
+      lsTr.push_back(TriangleIds{{a, b, b + 1}});
+      lsTr.push_back(TriangleIds{{a, b + 1, a + 1}});
+      lsTrOffsets.push_back(lsTr.size());
+    }
+  }
+  size_t nf = faceoffsets.size() - 1;
+  auto get_face_points = [&](size_t f) {
+    std::vector<Point3> pts;
+    for (int k = ringoffsets[f]; k < ringoffsets[f + 1]; k++)
+      pts.push_back(lsPts[ids[k]]);
+    return pts;
+  };
+  std::vector<CgalPolyhedron::Plane_3> planes;
+  for (size_t f = 0; f < nf; f++)
+    planes.push_back(get_best_fitted_plane(get_face_points(f)));
+  std::cout << nf << " faces, " << lsTr.size() << " triangles, " << repetitions << " repetitions" << std::endl;
+
+  float tol_d2p = 0.01f;
+  float tol_normals = 20.0f;
+  int nflagged = 0, ncgal = 0;
+  double value;
+  std::vector<char> flags;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < repetitions; r++)
+  {
+    for (size_t f = 0; f < nf; f++)
+    {
+      ncgal += !is_face_planar_distance2plane(get_face_points(f), planes[f], value, tol_d2p);
+      ncgal += !is_face_planar_normals(lsTr.data() + lsTrOffsets[f], lsTr.data() + lsTrOffsets[f + 1], lsPts, value, tol_normals);
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int r = 0; r < repetitions; r++)
+  {
+    flag_faces_distance2plane(lsPts, ids, ringoffsets, faceoffsets, planes, tol_d2p, flags);
+    for (auto& b : flags)
+      nflagged += b;
+    flag_faces_normals(lsPts, lsTr, lsTrOffsets, tol_normals, flags);
+    for (auto& b : flags)
+      nflagged += b;
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  double tcgal = std::chrono::duration<double, std::nano>(t1 - t0).count() / (double(repetitions) * nf);
+  double tfilter = std::chrono::duration<double, std::nano>(t2 - t1).count() / (double(repetitions) * nf);
+  std::cout << "CGAL for each face: " << tcgal << " ns/face (" << ncgal / repetitions << " not planar)" << std::endl;
+  std::cout << "pre-filters:        " << tfilter << " ns/face (" << nflagged / repetitions << " flagged)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,152 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2017, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+//-- microbenchmark: get_best_fitted_plane() vs linear_least_squares_fitting_3()
+//-- on all the faces of the POLY files in a folder (default: data/)
+//--
+//-- build with: cmake -DVAL3DITY_BENCHMARKS=ON ..
+//-- run with:   ./bench_plane_fit [folder] [repetitions]
+
+#include "geomtools.h"
+
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace val3dity;
+
+//-- each face is the list of the points of its rings
+void read_poly_faces(const std::string& ifile, std::vector<std::vector<Point3>>& faces)
+{
+  std::ifstream infile(ifile.c_str(), std::ifstream::in);
+  int num, tmpint;
+  if (!(infile >> num >> tmpint >> tmpint >> tmpint))
+    return;
+  std::vector<Point3> lsPts;
+  int base = 0;
+  for (int i = 0; i < num; i++)
+  {
+    int id;
+    double x, y, z;
+    if (!(infile >> id >> x >> y >> z))
+      return;
+    if (i == 0)
+      base = id;
+    lsPts.push_back(Point3(x, y, z));
+  }
+  int numf;
+  if (!(infile >> numf >> tmpint))
+    return;
+  for (int i = 0; i < numf; i++)
+  {
+    int numpolys, numholes;
+    std::string line;
+    std::getline(infile, line);
+    if (!std::getline(infile, line))
+      return;
+    std::istringstream ss(line);
+    if (!(ss >> numpolys))
+      return;
+    if (!(ss >> numholes))
+      numholes = 0;
+    std::vector<Point3> face;
+    for (int j = 0; j < numpolys; j++)
+    {
+      int n;
+      infile >> n;
+      for (int k = 0; k < n; k++)
+      {
+        int id;
+        infile >> id;
+        if ( (id - base < 0) || (id - base >= num) )
+          return;
+        face.push_back(lsPts[id - base]);
+      }
+    }
+    for (int j = 0; j < numholes; j++)
+    {
+      double x, y, z;
+      infile >> tmpint >> x >> y >> z;
+    }
+    if (face.size() >= 3)
+      faces.push_back(face);
+  }
+}
+
+
+int main(int argc, char* argv[])
+{
+  std::string folder = (argc > 1) ? argv[1] : "data";
+  int repetitions = (argc > 2) ? std::atoi(argv[2]) : 100;
+  std::vector<std::vector<Point3>> faces;
+  boost::filesystem::recursive_directory_iterator it(folder), end;
+  for ( ; it != end; it++)
+  {
+    if (it->path().extension() == ".poly")
+      read_poly_faces(it->path().string(), faces);
+  }
+  if (faces.empty() == true)
+  {
+    std::cout << "No faces found in " << folder << std::endl;
+    return 1;
+  }
+  std::cout << faces.size() << " faces, " << repetitions << " repetitions" << std::endl;
+  
+  double checksum = 0.0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < repetitions; r++)
+    for (auto& f : faces)
+      checksum += CGAL::to_double(get_best_fitted_plane_cgal(f).d());
+  auto t1 = std::chrono::steady_clock::now();
+  for (int r = 0; r < repetitions; r++)
+    for (auto& f : faces)
+      checksum += CGAL::to_double(get_best_fitted_plane(f).d());
+  auto t2 = std::chrono::steady_clock::now();
+  
+  //-- largest angle between the normals of both methods
+  double maxangle = 0.0;
+  for (auto& f : faces)
+  {
+    Vector n1 = get_best_fitted_plane_cgal(f).orthogonal_vector();
+    Vector n2 = get_best_fitted_plane(f).orthogonal_vector();
+    double dot = std::abs(CGAL::to_double(n1 * n2)) / std::sqrt(CGAL::to_double(n1.squared_length() * n2.squared_length()));
+    maxangle = std::max(maxangle, std::acos(std::min(1.0, dot)) * 180 / PI);
+  }
+  double tcgal = std::chrono::duration<double, std::micro>(t1 - t0).count() / (double(repetitions) * faces.size());
+  double tfast = std::chrono::duration<double, std::micro>(t2 - t1).count() / (double(repetitions) * faces.size());
+  std::cout << "linear_least_squares_fitting_3: " << tcgal << " us/face" << std::endl;
+  std::cout << "get_best_fitted_plane:          " << tfast << " us/face" << std::endl;
+  std::cout << "largest angle between normals:  " << maxangle << " degree" << std::endl;
+  std::cout << "(checksum " << checksum << ")" << std::endl;
+  return 0;
+}
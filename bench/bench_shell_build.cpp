@@ -0,0 +1,159 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2017, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+//-- microbenchmark: cost of the text round-trips removed
+//--   1. a shell written to an OFF stringstream and parsed back vs built 
+//--      directly with construct_CgalMesh(), both into a Surface_mesh, on 
+//--      triangulated tori of 1k to 1M triangles
+//--   2. the Nef polyhedra of get_aabb() and get_structuring_element_cube(),
+//--      built with OFF_to_nef_3 (as before) vs directly
+//--
+//-- build with: cmake -DVAL3DITY_BENCHMARKS=ON ..
+//-- run with:   ./bench_shell_build [repetitions]
+
+#include "validate_shell.h"
+#include "geomtools.h"
+#include "bench_tools.h"
+
+#include <CGAL/OFF_to_nef_3.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace val3dity;
+
+
+CgalMesh* construct_through_off(const std::vector<TriangleIds>& lsTr, const std::vector<Point3>& lsPts)
+{
+  std::stringstream offrep(std::stringstream::in | std::stringstream::out);
+  offrep << "OFF" << std::endl << lsPts.size() << " " << lsTr.size() << " 0" << std::endl;
+  for (auto& p : lsPts)
+    offrep << p << std::endl;
+  for (auto& t : lsTr)
+    offrep << "3 " << t[0] << " " << t[1] << " " << t[2] << std::endl;
+  CgalMesh* m = new CgalMesh();
+  offrep >> *m;
+  return m;
+}
+
+
+//-- the previous versions, through OFF text
+Nef_polyhedron* get_structuring_element_cube_off(float r)
+{
+  std::stringstream ss;
+  ss << "OFF\n8 6 0\n1 1 1\n-1 1 1\n1 -1 1\n-1 -1 1\n1 1 -1\n-1 1 -1\n1 -1 -1\n-1 -1 -1\n"
+     << "4 1 3 2 0\n4 2 6 4 0\n4 4 5 1 0\n4 5 4 6 7\n4 6 2 3 7\n4 3 1 5 7\n";
+  Nef_polyhedron* mycube = new Nef_polyhedron;
+  CGAL::OFF_to_nef_3(ss, *mycube);
+  Transformation scale(CGAL::SCALING, r);
+  mycube->transform(scale);
+  return mycube;
+}
+
+Nef_polyhedron* get_aabb_off(double xmin, double ymin, double zmin, double xmax, double ymax, double zmax)
+{
+  std::stringstream ss;
+  ss << "OFF\n8 6 0\n"
+     << xmin << " " << ymin << " " << zmin << "\n" << xmax << " " << ymin << " " << zmin << "\n"
+     << xmax << " " << ymax << " " << zmin << "\n" << xmin << " " << ymax << " " << zmin << "\n"
+     << xmin << " " << ymin << " " << zmax << "\n" << xmax << " " << ymin << " " << zmax << "\n"
+     << xmax << " " << ymax << " " << zmax << "\n" << xmin << " " << ymax << " " << zmax << "\n"
+     << "4 0 3 2 1\n4 0 1 5 4\n4 1 2 6 5\n4 2 3 7 6\n4 0 4 7 3\n4 4 5 6 7\n";
+  Nef_polyhedron* nefbbox = new Nef_polyhedron;
+  CGAL::OFF_to_nef_3(ss, *nefbbox);
+  return nefbbox;
+}
+
+
+int main(int argc, char* argv[])
+{
+  int reps = (argc > 1) ? std::atoi(argv[1]) : 3;
+  std::cout << "Shell into a Surface_mesh" << std::endl;
+  std::cout << "triangles      OFF (ms)   direct (ms)   speedup" << std::endl;
+  for (int n : {23, 71, 224, 708})
+  {
+    std::vector<Point3> lsPts;
+    std::vector<TriangleIds> lsTr;
+    build_torus(n, lsPts, lsTr);
+    double toff = 0.0, tdirect = 0.0;
+    for (int i = 0; i < reps; i++)
+    {
+      auto t0 = std::chrono::steady_clock::now();
+      CgalMesh* p = construct_through_off(lsTr, lsPts);
+      auto t1 = std::chrono::steady_clock::now();
+      CgalMesh* m = construct_CgalMesh(lsTr, lsPts);
+      auto t2 = std::chrono::steady_clock::now();
+      if ( (p->number_of_faces() != lsTr.size()) || (m == NULL) || (m->number_of_faces() != lsTr.size()) )
+      {
+        std::cerr << "ERROR: the shell of " << lsTr.size() << " triangles was not built" << std::endl;
+        return 1;
+      }
+      toff    += std::chrono::duration<double, std::milli>(t1 - t0).count();
+      tdirect += std::chrono::duration<double, std::milli>(t2 - t1).count();
+      delete p;
+      delete m;
+    }
+    std::cout << std::setw(9) << lsTr.size() 
+              << std::setw(14) << toff / reps 
+              << std::setw(14) << tdirect / reps 
+              << std::setw(10) << toff / tdirect << std::endl;
+  }
+
+  //-- the Nef polyhedra, the bbox is the one of a cube of size 1 (+10 units)
+  int nefreps = 100 * reps;
+  Nef_polyhedron* unitcube = get_structuring_element_cube(0.5);
+  double t[4] = {0.0, 0.0, 0.0, 0.0};
+  for (int i = 0; i < nefreps; i++)
+  {
+    auto t0 = std::chrono::steady_clock::now();
+    Nef_polyhedron* a = get_structuring_element_cube_off(0.5);
+    auto t1 = std::chrono::steady_clock::now();
+    Nef_polyhedron* b = get_structuring_element_cube(0.5);
+    auto t2 = std::chrono::steady_clock::now();
+    Nef_polyhedron* c = get_aabb_off(-10.5, -10.5, -10.5, 10.5, 10.5, 10.5);
+    auto t3 = std::chrono::steady_clock::now();
+    Nef_polyhedron* d = get_aabb(unitcube);
+    auto t4 = std::chrono::steady_clock::now();
+    t[0] += std::chrono::duration<double, std::micro>(t1 - t0).count();
+    t[1] += std::chrono::duration<double, std::micro>(t2 - t1).count();
+    t[2] += std::chrono::duration<double, std::micro>(t3 - t2).count();
+    t[3] += std::chrono::duration<double, std::micro>(t4 - t3).count();
+    delete a;
+    delete b;
+    delete c;
+    delete d;
+  }
+  delete unitcube;
+  std::cout << std::endl << "Nef polyhedra        OFF (us)   direct (us)" << std::endl;
+  std::cout << "structuring element" << std::setw(12) << t[0] / nefreps << std::setw(14) << t[1] / nefreps << std::endl;
+  std::cout << "aabb               " << std::setw(12) << t[2] / nefreps << std::setw(14) << t[3] / nefreps 
+            << "  (direct includes the scan of the vertices)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,116 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2017, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+//-- microbenchmark: memory (live bytes per triangle) and construction time 
+//-- of a shell stored as a Polyhedron_3 and as a Surface_mesh, on a 
+//-- triangulated torus with n x n vertices (2 n^2 triangles)
+//--
+//-- build with: cmake -DVAL3DITY_BENCHMARKS=ON ..
+//-- run with:   ./bench_shell_memory [n]
+
+#include "definitions.h"
+#include "bench_tools.h"
+
+#include <CGAL/boost/graph/copy_face_graph.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+using namespace val3dity;
+
+//-- the live bytes on the heap: each block stores its size before it
+static std::atomic<long long> live_bytes(0);
+static const size_t HEADER = 16;
+
+void* operator new(size_t size)
+{
+  char* p = static_cast<char*>(std::malloc(size + HEADER));
+  if (p == NULL)
+    throw std::bad_alloc();
+  *reinterpret_cast<size_t*>(p) = size;
+  live_bytes += size;
+  return p + HEADER;
+}
+
+void operator delete(void* ptr) noexcept
+{
+  if (ptr == NULL)
+    return;
+  char* p = static_cast<char*>(ptr) - HEADER;
+  live_bytes -= *reinterpret_cast<size_t*>(p);
+  std::free(p);
+}
+
+void* operator new[](size_t size)                 { return operator new(size); }
+void  operator delete[](void* ptr) noexcept       { operator delete(ptr); }
+void  operator delete(void* ptr, size_t) noexcept   { operator delete(ptr); }
+void  operator delete[](void* ptr, size_t) noexcept { operator delete(ptr); }
+
+
+int main(int argc, char* argv[])
+{
+  int n = (argc > 1) ? std::atoi(argv[1]) : 500;
+  std::vector<Point3> lsPts;
+  std::vector<TriangleIds> lsTr;
+  build_torus(n, lsPts, lsTr);
+  double ntr = static_cast<double>(lsTr.size());
+  std::cout << "Torus: " << lsPts.size() << " vertices, " << lsTr.size() << " triangles" << std::endl;
+
+  //-- Surface_mesh, as built by construct_CgalMesh()
+  long long before = live_bytes;
+  auto t0 = std::chrono::steady_clock::now();
+  CgalMesh* mesh = new CgalMesh();
+  mesh->reserve(static_cast<CgalMesh::size_type>(lsPts.size()), 
+                static_cast<CgalMesh::size_type>((3 * lsTr.size() + 1) / 2), 
+                static_cast<CgalMesh::size_type>(lsTr.size()));
+  for (auto& p : lsPts)
+    mesh->add_vertex(p);
+  for (auto& t : lsTr)
+    mesh->add_face(CgalMesh::Vertex_index(t[0]), CgalMesh::Vertex_index(t[1]), CgalMesh::Vertex_index(t[2]));
+  auto t1 = std::chrono::steady_clock::now();
+  long long bytesmesh = live_bytes - before;
+
+  //-- Polyhedron_3 with the same connectivity
+  before = live_bytes;
+  auto t2 = std::chrono::steady_clock::now();
+  CgalPolyhedron* poly = new CgalPolyhedron();
+  CGAL::copy_face_graph(*mesh, *poly);
+  auto t3 = std::chrono::steady_clock::now();
+  long long bytespoly = live_bytes - before;
+
+  std::cout << "Polyhedron_3: " << bytespoly / ntr << " bytes/triangle (copy: " 
+            << std::chrono::duration<double, std::milli>(t3 - t2).count() << " ms)" << std::endl;
+  std::cout << "Surface_mesh: " << bytesmesh / ntr << " bytes/triangle (build: " 
+            << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms)" << std::endl;
+  std::cout << "Ratio:        " << static_cast<double>(bytespoly) / bytesmesh << std::endl;
+  delete poly;
+  delete mesh;
+  return 0;
+}
@@ -0,0 +1,71 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2017, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+//-- the tools shared by the microbenchmarks
+
+#ifndef __val3dity__bench_tools__
+#define __val3dity__bench_tools__
+
+#include "definitions.h"
+
+#include <cmath>
+#include <vector>
+
+namespace val3dity
+{
+
+//-- a closed triangulated torus of 2*n*n triangles (n*n vertices)
+inline void build_torus(int n, std::vector<Point3>& lsPts, std::vector<TriangleIds>& lsTr)
+{
+  const double R = 10.0, r = 3.0;
+  for (int i = 0; i < n; i++)
+  {
+    double u = 2 * M_PI * i / n;
+    for (int j = 0; j < n; j++)
+    {
+      double v = 2 * M_PI * j / n;
+      lsPts.push_back(Point3((R + r * cos(v)) * cos(u), (R + r * cos(v)) * sin(u), r * sin(v)));
+    }
+  }
+  for (int i = 0; i < n; i++)
+  {
+    for (int j = 0; j < n; j++)
+    {
+      int a = i * n + j;
+      int b = ((i + 1) % n) * n + j;
+      int c = ((i + 1) % n) * n + (j + 1) % n;
+      int d = i * n + (j + 1) % n;
+      lsTr.push_back(TriangleIds{{a, b, c}});
+      lsTr.push_back(TriangleIds{{a, c, d}});
+    }
+  }
+}
+
+} // namespace val3dity
+
+#endif /* defined(__val3dity__bench_tools__) */
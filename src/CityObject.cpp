@@ -47,14 +47,14 @@ CityObject::~CityObject()
 {}
 
 
-bool CityObject::validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap) 
+bool CityObject::validate(const ValidationContext& ctx) 
 {
   if (_is_valid != -1)
     return _is_valid;
-  bool bValid = Feature::validate_generic(tol_planarity_d2p, tol_planarity_normals, tol_overlap);
+  bool bValid = Feature::validate_generic(ctx);
   //-- Building
   if ( (bValid == true) && (this->_type == "Building") )
-    bValid = validate_building(tol_overlap);
+    bValid = validate_building(ctx.get_tol_overlap());
   _is_valid = bValid;
   return bValid;
 }
@@ -37,11 +37,16 @@ CompositeSolid::CompositeSolid(std::string id)
 {
   _id = id;
   _is_valid = -1;
+  _nef = NULL;
 }
 
 
 CompositeSolid::~CompositeSolid()
-{}
+{
+  for (auto& s : _lsSolids)
+    delete s;
+  delete _nef;
+}
 
 
 Primitive3D CompositeSolid::get_type() 
@@ -59,7 +64,6 @@ Nef_polyhedron* CompositeSolid::get_nef_polyhedron()
   {
     Nef_polyhedron* tmp = _lsSolids[i]->get_nef_polyhedron();
     *unioned = *unioned + *tmp;
-    delete tmp;
   }
   _nef = unioned;
   return unioned;
@@ -91,12 +95,13 @@ void CompositeSolid::translate_vertices()
 }
 
 
-bool CompositeSolid::validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap) 
+bool CompositeSolid::validate(const ValidationContext& ctx) 
 {
+  double tol_overlap = ctx.get_tol_overlap();
   bool isValid = true;
   for (auto& s : _lsSolids)
   {
-    if (s->validate(tol_planarity_d2p, tol_planarity_normals) == false)
+    if (s->validate(ctx) == false)
       isValid = false;
   }
   if (isValid == true) 
@@ -179,15 +184,12 @@ bool CompositeSolid::validate(double tol_planarity_d2p, double tol_planarity_nor
         this->add_error(503, "", msg.str());
         isValid = false;
       }
-      for (auto each : lsNefsDilated)
-        delete each;
+      if (tol_overlap > 0.0)
+      {
+        for (auto each : lsNefsDilated)
+          delete each;
+      }
     } 
-    //-- clear the temp Nefs
-    if (tol_overlap > 0.0)
-    {
-      for (auto each: lsNefs)
-        delete each;
-    }
   }
   _is_valid = isValid;
   return isValid;
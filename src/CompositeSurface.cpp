@@ -36,16 +36,18 @@ namespace val3dity
 CompositeSurface::CompositeSurface(std::string id) {
   _id = id;
   _is_valid = -1;
+  _surface = NULL;
 }
 
 CompositeSurface::~CompositeSurface() {
+  delete _surface;
 }
 
-bool CompositeSurface::validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap)
+bool CompositeSurface::validate(const ValidationContext& ctx)
 {
   if (this->is_valid() == 0)
     return false;
-  if (_surface->validate_as_compositesurface(tol_planarity_d2p, tol_planarity_normals) == true) 
+  if (_surface->validate_as_compositesurface(ctx.get_tol_planarity_d2p(), ctx.get_tol_planarity_normals()) == true) 
   {
     _is_valid = 1;
     return true;
@@ -43,7 +43,7 @@ public:
               CompositeSurface(std::string id = ""); 
               ~CompositeSurface(); 
 
-  bool          validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap = -1);
+  bool          validate(const ValidationContext& ctx);
   int           is_valid();
   bool          is_empty();
   json          get_report_json();
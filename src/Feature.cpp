@@ -28,12 +28,20 @@
 
 #include "Feature.h"
 #include "input.h"
+#include "parallel.h"
 #include <iostream>
 
 namespace val3dity
 {
 
 
+Feature::~Feature()
+{
+  //-- GeometryTemplates are shared by several Features and are freed separately
+  for (auto& p : _lsPrimitives)
+    if (p->get_type() != GEOMETRYTEMPLATE)
+      delete p;
+}
 
 
 std::string Feature::get_id()
@@ -97,7 +105,7 @@ const std::vector<Primitive*>& Feature::get_primitives()
 }
 
 
-bool Feature::validate_generic(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap)
+bool Feature::validate_generic(const ValidationContext& ctx)
 {
   std::clog << std::endl << "######### Validating Feature #########" << std::endl;
   std::clog << "id:   " << this->get_id() << std::endl;
@@ -111,40 +119,66 @@ bool Feature::validate_generic(double tol_planarity_d2p, double tol_planarity_no
   if (_lsPrimitives.size() > 500) {
     std::cout << "Validating " << _lsPrimitives.size() << " geometric primitives, this could be slow." << std::endl << std::flush;
   }
-  for (auto& p : _lsPrimitives)
+  if ( (TaskScheduler::get_number_threads() > 1) && (_lsPrimitives.size() > 1) )
   {
-    std::clog << "======== Validating Primitive ========" << std::endl;
-    switch(p->get_type())
+    //-- the primitives are validated concurrently (idle threads steal them),
+    //-- each logs to its own string and these are appended in their order
+    std::vector<std::string> logs(_lsPrimitives.size());
+    std::vector<char> valid(_lsPrimitives.size(), 1);
+    TaskScheduler::parallel_for(_lsPrimitives.size(), [&](size_t i) {
+      std::string* prev = ThreadLogBuffer::capture(&(logs[i]));
+      valid[i] = this->validate_primitive(_lsPrimitives[i], ctx);
+      ThreadLogBuffer::capture(prev);
+    });
+    for (std::size_t i = 0; i < _lsPrimitives.size(); i++)
     {
-      case 0: std::clog << "Solid"             << std::endl; break;
-      case 1: std::clog << "CompositeSolid"    << std::endl; break;
-      case 2: std::clog << "MultiSolid"        << std::endl; break;
-      case 3: std::clog << "CompositeSurface"  << std::endl; break;
-      case 4: std::clog << "MultiSurface"      << std::endl; break;
-      case 5: std::clog << "GeometryTemplate"  << std::endl; break;
-      case 9: std::clog << "ALL"               << std::endl; break;
+      std::clog << logs[i];
+      if (valid[i] == 0)
+        bValid = false;
     }
-    std::clog << "id: " << p->get_id() << std::endl;
-    std::clog << "--" << std::endl;
-    if (p->validate(tol_planarity_d2p, tol_planarity_normals, tol_overlap) == false)
-    {
-      std::clog << "======== INVALID ========" << std::endl;
-      bValid = false;
-    }
-    else
-      std::clog << "========= VALID =========" << std::endl;
+  }
+  else
+  {
+    for (auto& p : _lsPrimitives)
+      if (this->validate_primitive(p, ctx) == false)
+        bValid = false;
   }
   _is_valid = bValid;
   return bValid;
 }  
 
 
+bool Feature::validate_primitive(Primitive* p, const ValidationContext& ctx)
+{
+  std::clog << "======== Validating Primitive ========" << std::endl;
+  switch(p->get_type())
+  {
+    case 0: std::clog << "Solid"             << std::endl; break;
+    case 1: std::clog << "CompositeSolid"    << std::endl; break;
+    case 2: std::clog << "MultiSolid"        << std::endl; break;
+    case 3: std::clog << "CompositeSurface"  << std::endl; break;
+    case 4: std::clog << "MultiSurface"      << std::endl; break;
+    case 5: std::clog << "GeometryTemplate"  << std::endl; break;
+    case 9: std::clog << "ALL"               << std::endl; break;
+  }
+  std::clog << "id: " << p->get_id() << std::endl;
+  std::clog << "--" << std::endl;
+  if (p->validate(ctx) == false)
+  {
+    std::clog << "======== INVALID ========" << std::endl;
+    return false;
+  }
+  std::clog << "========= VALID =========" << std::endl;
+  return true;
+}
+
+
 void Feature::add_error(int code, std::string whichgeoms, std::string info)
 {
   _is_valid = 0;
   std::tuple<std::string, std::string> a(whichgeoms, info);
   _errors[code].push_back(a);
-  std::clog << "\tERROR " << code << ": " << ALL_ERRORS[code];
+  std::clog << "\tERROR " << code << ": " << ALL_ERRORS.at(code);
   if (whichgeoms.empty() == false)
     std::clog << " (id: " << whichgeoms << ")";
   std::clog << std::endl;
@@ -45,8 +45,9 @@ namespace val3dity
 class Feature
 {
 public:
+  virtual ~Feature();
 
-  virtual bool            validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap = -1) = 0;
+  virtual bool            validate(const ValidationContext& ctx) = 0;
   virtual bool            is_valid() = 0;
   virtual std::string     get_type() = 0;
 
@@ -61,8 +62,8 @@ public:
   int                     number_of_primitives();
 
   void                    add_error(int code, std::string info, std::string whichgeoms);
-  json                    get_report_json();
-  std::set<int>           get_unique_error_codes();
+  virtual json            get_report_json();
+  virtual std::set<int>   get_unique_error_codes();
 
 protected:
   int                     _is_valid; 
@@ -70,7 +71,8 @@ protected:
   std::string             _type;
   std::vector<Primitive*> _lsPrimitives;
   
-  bool                    validate_generic(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap = -1);  
+  bool                    validate_generic(const ValidationContext& ctx);  
+  bool                    validate_primitive(Primitive* p, const ValidationContext& ctx);
   
   std::map<int, std::vector< std::tuple< std::string, std::string > > > _errors;
 
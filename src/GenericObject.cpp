@@ -46,11 +46,11 @@ GenericObject::~GenericObject()
 {}
 
 
-bool GenericObject::validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap) 
+bool GenericObject::validate(const ValidationContext& ctx) 
 {
   if (_is_valid != -1)
     return _is_valid;
-  bool bValid = Feature::validate_generic(tol_planarity_d2p, tol_planarity_normals, tol_overlap);
+  bool bValid = Feature::validate_generic(ctx);
   _is_valid = bValid;
   return bValid;
 }
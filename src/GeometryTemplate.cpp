@@ -38,6 +38,8 @@ GeometryTemplate::GeometryTemplate(std::string id) {
 }
 
 GeometryTemplate::~GeometryTemplate() {
+  for (auto& p : _lsPrimitives)
+    delete p;
 }
 
 Primitive3D GeometryTemplate::get_type() 
@@ -45,12 +47,17 @@ Primitive3D GeometryTemplate::get_type()
   return GEOMETRYTEMPLATE;
 }
 
-bool GeometryTemplate::validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap) 
+bool GeometryTemplate::validate(const ValidationContext& ctx) 
 {
+  //-- a template is shared by all its instances (maybe in different threads)
+  //-- so it is validated only once
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_is_valid != -1)
+    return (_is_valid == 1);
   bool isValid = true;
   for (auto& p : _lsPrimitives)
   {
-    if (p->validate(tol_planarity_d2p, tol_planarity_normals) == false)
+    if (p->validate(ctx) == false)
       isValid = false;
   }
   _is_valid = isValid;
@@ -34,6 +34,7 @@
 
 #include <string>
 #include <vector>
+#include <mutex>
 
 namespace val3dity
 {
@@ -44,7 +45,7 @@ public:
                 GeometryTemplate(std::string id = ""); 
                 ~GeometryTemplate(); 
 
-  bool          validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap = -1);
+  bool          validate(const ValidationContext& ctx);
   int           is_valid();
   bool          is_empty();
   json          get_report_json();
@@ -58,6 +59,7 @@ public:
 
 protected:
   std::vector<Primitive*> _lsPrimitives;
+  std::mutex              _mutex;
 };
 
 } // namespace val3dity
@@ -45,10 +45,13 @@ IndoorModel::IndoorModel(std::string theid)
 
 
 IndoorModel::~IndoorModel()
-{}
+{
+  for (auto& g : _graphs)
+    delete g;
+}
 
 
-bool IndoorModel::validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap) 
+bool IndoorModel::validate(const ValidationContext& ctx) 
 {
   // 
   // 1. each Cell is valid Solid
@@ -65,7 +68,7 @@ bool IndoorModel::validate(double tol_planarity_d2p, double tol_planarity_normal
   bool bValid = true;
 //-- 1. 4xx - ISO19107 check for Solid validity
 //--    validate each IndoorCell geometry (Solids)
-  bValid = Feature::validate_generic(tol_planarity_d2p, tol_planarity_normals, tol_overlap);
+  bValid = Feature::validate_generic(ctx);
 
 //-- 2. 701 - CELLS_OVERLAP
 //--    overlapping test
@@ -74,7 +77,7 @@ bool IndoorModel::validate(double tol_planarity_d2p, double tol_planarity_normal
   for (auto& el : _cells)
     lsCells.push_back(std::make_tuple(el.first, (Solid*)_lsPrimitives[std::get<0>(el.second)]));
   std::vector<Error> lsErrors;  
-  if (are_cells_interior_disconnected_with_aabb(lsCells, 701, lsErrors, tol_overlap) == false)
+  if (are_cells_interior_disconnected_with_aabb(lsCells, 701, lsErrors, ctx.get_tol_overlap()) == false)
   {
     bValid = false;
     std::clog << "Error: Cells have overlapping interior" << std::endl;
@@ -208,7 +211,7 @@ bool IndoorModel::validate(double tol_planarity_d2p, double tol_planarity_normal
         std::clog << "Cells id=" << el.first << " id=" << cadjid;
         int re = are_primitives_adjacent(_lsPrimitives[std::get<0>(el.second)],
                                          _lsPrimitives[std::get<0>(_cells[cadjid])],
-                                         tol_overlap);
+                                         ctx.get_tol_overlap());
         if (re == 0) {
           std::stringstream msg;
           msg << "Cells id=" << el.first << " & id=" << cadjid;
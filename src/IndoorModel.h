@@ -43,7 +43,7 @@ public:
   IndoorModel(std::string theid);
   ~IndoorModel();
   
-  bool            validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap = -1);
+  bool            validate(const ValidationContext& ctx);
   bool            is_valid();
   std::string     get_type();
 
@@ -38,6 +38,8 @@ MultiSolid::MultiSolid(std::string id) {
 }
 
 MultiSolid::~MultiSolid() {
+  for (auto& s : _lsSolids)
+    delete s;
 }
 
 Primitive3D MultiSolid::get_type() 
@@ -45,12 +47,12 @@ Primitive3D MultiSolid::get_type()
   return MULTISOLID;
 }
 
-bool MultiSolid::validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap) 
+bool MultiSolid::validate(const ValidationContext& ctx) 
 {
   bool isValid = true;
   for (auto& s : _lsSolids)
   {
-    if (s->validate(tol_planarity_d2p, tol_planarity_normals) == false)
+    if (s->validate(ctx) == false)
       isValid = false;
   }
   _is_valid = isValid;
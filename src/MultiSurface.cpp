@@ -36,16 +36,18 @@ namespace val3dity
 MultiSurface::MultiSurface(std::string id) {
   _id = id;
   _is_valid = -1;
+  _surface = NULL;
 }
 
 MultiSurface::~MultiSurface() {
+  delete _surface;
 }
 
-bool MultiSurface::validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap)
+bool MultiSurface::validate(const ValidationContext& ctx)
 {
   if (this->is_valid() == 0)
     return false;
-  if (_surface->validate_as_multisurface(tol_planarity_d2p, tol_planarity_normals) == true) 
+  if (_surface->validate_as_multisurface(ctx.get_tol_planarity_d2p(), ctx.get_tol_planarity_normals()) == true) 
   {
     _is_valid = 1;
     return true;
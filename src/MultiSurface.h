@@ -44,7 +44,7 @@ public:
               MultiSurface(std::string id = ""); 
               ~MultiSurface(); 
 
-  bool          validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap = -1);
+  bool          validate(const ValidationContext& ctx);
   int           is_valid();
   bool          is_empty();
   json          get_report_json();
@@ -33,23 +33,12 @@
 namespace val3dity
 {
 
-double Primitive::_shiftx = 0.0;
-double Primitive::_shifty = 0.0;
-
-
 Primitive::Primitive() {
 }
 
 Primitive::~Primitive() {
 }
 
-void Primitive::set_translation_min_values(double minx, double miny)
-{
-  Primitive::_shiftx = minx;
-  Primitive::_shifty = miny;
-}
-
-
 std::string  Primitive::get_id()
 {
   return _id;
@@ -65,7 +54,7 @@ void Primitive::add_error(int code, std::string whichgeoms, std::string info)
   _is_valid = 0;
   std::tuple<std::string, std::string> a(whichgeoms, info);
   _errors[code].push_back(a);
-  std::clog << "\tERROR " << code << ": " << ALL_ERRORS[code];
+  std::clog << "\tERROR " << code << ": " << ALL_ERRORS.at(code);
   if (whichgeoms.empty() == false)
     std::clog << " (id: " << whichgeoms << ")";
   std::clog << std::endl;
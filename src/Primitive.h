@@ -30,6 +30,7 @@
 #define Primitive_h
 
 #include "definitions.h"
+#include "ValidationContext.h"
 #include "nlohmann-json/json.hpp"
 #include <map>
 #include <vector>
@@ -46,9 +47,9 @@ class Primitive
 {
 public:
   Primitive  ();
-  ~Primitive ();
+  virtual ~Primitive ();
 
-  virtual bool          validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap = -1) = 0;
+  virtual bool          validate(const ValidationContext& ctx) = 0;
   virtual int           is_valid() = 0;
   virtual bool          is_empty() = 0;
   virtual json          get_report_json() = 0;
@@ -56,7 +57,6 @@ public:
 
   virtual void          get_min_bbox(double& x, double& y) = 0;
   virtual void          translate_vertices() = 0;
-  static void           set_translation_min_values(double minx, double miny);
 
   std::string           get_id();
   void                  set_id(std::string id);
@@ -66,8 +66,6 @@ public:
 protected:
   std::string           _id;
   int                   _is_valid; 
-  static double         _shiftx;
-  static double         _shifty;
 
   std::map<int, std::vector< std::tuple< std::string, std::string > > > _errors;
 
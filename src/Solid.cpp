@@ -32,6 +32,7 @@
 
 #include "input.h"
 #include "validate_shell.h"
+#include <CGAL/boost/graph/copy_face_graph.h>
 
 namespace val3dity
 {
@@ -45,7 +46,11 @@ Solid::Solid(std::string id)
 
 
 Solid::~Solid()
-{}
+{
+  for (auto& sh : _shells)
+    delete sh;
+  delete _nef;
+}
 
 Surface* Solid::get_oshell()
 {
@@ -133,7 +138,7 @@ void Solid::translate_vertices()
 }
 
 
-bool Solid::validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap)
+bool Solid::validate(const ValidationContext& ctx)
 {
   if (this->is_valid() == 0)
   {
@@ -153,7 +158,7 @@ bool Solid::validate(double tol_planarity_d2p, double tol_planarity_normals, dou
   }
   for (auto& sh : _shells)
   {
-    if (sh->validate_as_shell(tol_planarity_d2p, tol_planarity_normals) == false) 
+    if (sh->validate_as_shell(ctx.get_tol_planarity_d2p(), ctx.get_tol_planarity_normals()) == false) 
       isValid = false;
   }
   if (isValid == true) 
@@ -225,10 +230,9 @@ Nef_polyhedron* Solid::get_nef_polyhedron()
   std::vector<Nef_polyhedron> nefs;
   for (auto& sh : this->get_shells())
   {
-    //-- convert to an EPEC Polyhedron so that convertion to Nef is possible
+    //-- copy to an EPEC Polyhedron so that convertion to Nef is possible
     CgalPolyhedronE pe;
-    Polyhedron_convert polyhedron_converter(*(sh->get_cgal_polyhedron()));
-    pe.delegate(polyhedron_converter);
+    CGAL::copy_face_graph(*(sh->get_cgal_mesh()), pe);
     Nef_polyhedron onef(pe);
     nefs.push_back(onef);
   }
@@ -308,7 +312,7 @@ bool Solid::validate_solid_with_nef()
   int i = 0;
   for (auto& sh : this->get_shells())
   {
-    if (check_global_orientation_normals(sh->get_cgal_polyhedron(), i == 0) == false) 
+    if (check_global_orientation_normals(sh->get_cgal_mesh(), i == 0) == false) 
     {
       this->add_error(405, "i", "");
       isValid = false;
@@ -325,10 +329,9 @@ bool Solid::validate_solid_with_nef()
   std::vector<Nef_polyhedron> nefs;
   for (auto& sh : this->get_shells())
   {
-    //-- convert to an EPEC Polyhedron so that convertion to Nef is possible
+    //-- copy to an EPEC Polyhedron so that convertion to Nef is possible
     CgalPolyhedronE pe;
-    Polyhedron_convert polyhedron_converter(*(sh->get_cgal_polyhedron()));
-    pe.delegate(polyhedron_converter);
+    CGAL::copy_face_graph(*(sh->get_cgal_mesh()), pe);
     Nef_polyhedron onef(pe);
     nefs.push_back(onef);
   }
@@ -442,8 +445,8 @@ bool Solid::validate_solid_with_nef()
 
 CGAL::Bbox_3 Solid::get_bbox() 
 {
-  CgalPolyhedron* poly = this->get_oshell()->get_cgal_polyhedron();
-  return CGAL::Polygon_mesh_processing::bbox(*poly);
+  CgalMesh* mesh = this->get_oshell()->get_cgal_mesh();
+  return CGAL::Polygon_mesh_processing::bbox(*mesh);
 }
 
 
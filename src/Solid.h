@@ -56,7 +56,7 @@ public:
   int             num_faces();
   int             num_vertices();
  
-  bool            validate(double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap = -1);
+  bool            validate(const ValidationContext& ctx);
   Nef_polyhedron* get_nef_polyhedron();
   void            get_min_bbox(double& x, double& y);
   void            translate_vertices();
@@ -31,10 +31,19 @@
 #include "geomtools.h"
 #include "input.h"
 #include "validate_shell.h"
-#include <CGAL/Polygon_mesh_processing/self_intersections.h>
+#include "validate_polygon.h"
+#include "ValidationContext.h"
+#include "parallel.h"
+#include <CGAL/box_intersection_d.h>
+#include <CGAL/intersections.h>
 #include <CGAL/Side_of_triangle_mesh.h>
 #include <geos_c.h>
 #include <sstream>
+#include <map>
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <cmath>
 
 using namespace std;
 
@@ -43,21 +52,65 @@ using namespace std;
 namespace val3dity
 {
 
-double Surface::_shiftx = 0.0;
-double Surface::_shifty = 0.0;
+//-- one GEOS context per thread (reentrant API), created when first needed
+//-- and finished when the thread exits
+struct GEOSThreadContext
+{
+  GEOSContextHandle_t handle;
+  GEOSThreadContext() { handle = GEOS_init_r(); }
+  ~GEOSThreadContext() { GEOS_finish_r(handle); }
+};
+
+static GEOSContextHandle_t get_geos_handle()
+{
+  thread_local GEOSThreadContext c;
+  return c.handle;
+}
+
+//-- the reasons of GEOSisValidDetail_r() and their error code
+static const std::map<std::string, int> GEOS_REASONS = {
+  {"Self-intersection",       201},
+  {"Ring Self-intersection",  201},
+  {"Duplicate Rings",         202},
+  {"Interior is disconnected",205},
+  {"Hole lies outside shell", 206},
+  {"Holes are nested",        207}
+};
+
+//-- a GEOS linear ring, closed, from a projected ring
+static GEOSGeometry* create_geos_ring(GEOSContextHandle_t h, const Polygon& pgn, bool reversed)
+{
+  unsigned int n = static_cast<unsigned int>(pgn.size());
+  GEOSCoordSequence* cs = GEOSCoordSeq_create_r(h, n + 1, 2);
+  for (unsigned int k = 0; k <= n; k++)
+  {
+    const Point2& p = (reversed == false) ? pgn[k % n] : pgn[(n - (k % n)) % n];
+    GEOSCoordSeq_setX_r(h, cs, k, CGAL::to_double(p.x()));
+    GEOSCoordSeq_setY_r(h, cs, k, CGAL::to_double(p.y()));
+  }
+  return GEOSGeom_createLinearRing_r(h, cs);
+}
 
-Surface::Surface(int id, double tol_snap)
+Surface::Surface(const ValidationContext& ctx, int id, bool snap)
 {
   _id = id;
   _is_valid_2d = -1;
   _vertices_added = 0;
-  _tol_snap = tol_snap;
+  _mesh = NULL;
+  _tol_snap = (snap == true) ? ctx.get_tol_snap() : 0.0;
+  _polygon_engine = ctx.get_polygon_engine();
+  _min_triangles_parallel = ctx.get_min_triangles_parallel();
+  _auto_orient = ctx.get_auto_orient();
+  _shiftx = ctx.get_translation_x();
+  _shifty = ctx.get_translation_y();
+  _lsRingOffsets.push_back(0);
+  _lsFaceOffsets.push_back(0);
+  _lsTrOffsets.push_back(0);
 }
 
 Surface::~Surface()
 {
-  // TODO: clear memory properly
-  _lsPts.clear();
+  delete _mesh;
 }
 
 int Surface::get_id()
@@ -65,9 +118,9 @@ int Surface::get_id()
   return _id;
 }
 
-CgalPolyhedron* Surface::get_cgal_polyhedron()
+CgalMesh* Surface::get_cgal_mesh()
 {
-  return _polyhedron;
+  return _mesh;
 }
 
 bool Surface::has_errors()
@@ -77,7 +130,7 @@ return !(_errors.empty());
 
 bool Surface::is_empty()
 {
-  return (_lsPts.empty() || _lsFaces.empty());
+  return (_lsPts.empty() || (this->number_faces() == 0));
 }
 
 
@@ -85,7 +138,7 @@ void Surface::add_error(int code, std::string faceid, std::string info)
 {
   std::tuple<std::string, std::string> a(faceid, info);
   _errors[code].push_back(a);
-  std::clog << "\tERROR " << code << ": " << ALL_ERRORS[code];
+  std::clog << "\tERROR " << code << ": " << ALL_ERRORS.at(code);
   if (faceid.empty() == false)
     std::clog << " (face " << faceid << ")";
   std::clog << std::endl;
@@ -136,12 +189,13 @@ std::string Surface::get_poly_representation()
     i++;
   }
   //-- faces
-  s << _lsFaces.size() << " 0" << std::endl;
-  for (auto& f : _lsFaces)
+  s << this->number_faces() << " 0" << std::endl;
+  for (int f = 0; f < this->number_faces(); f++)
   {
-    s << f.size() << " " << (f.size() - 1) << std::endl;
-    for (auto& r : f)
+    s << this->number_rings(f) << " " << (this->number_rings(f) - 1) << std::endl;
+    for (int j = 0; j < this->number_rings(f); j++)
     {
+      RingView r = this->get_ring(f, j);
       s << r.size() << " ";
       for (auto p : r)
       {
@@ -159,39 +213,51 @@ std::string Surface::get_off_representation()
 {
   std::stringstream ss;
   ss << "OFF" << std::endl;
-  int notr = 0;
-  for (auto& f: _lsTr) 
-    for (auto& t: f) 
-      notr++;
-  ss << _lsPts.size() << " " << notr << " 0" << std::endl;
+  ss << _lsPts.size() << " " << _lsTr.size() << " 0" << std::endl;
   //-- points
   for (auto& p : _lsPts)
     ss << setprecision(15) << p.x() << " " << p.y() << " " << p.z() << std::endl;
   //-- triangles
-  for (auto& f: _lsTr)
-  {
-    for (auto& t: f) 
-    {
-      ss << "3 " << t[0] << " " << t[1] << " " << t[2] << std::endl;
-    }
-  }
+  for (auto& t: _lsTr)
+    ss << "3 " << t[0] << " " << t[1] << " " << t[2] << std::endl;
   return ss.str();
 }
 
 
-std::string Surface::get_coords_key(Point3* p)
+//-- the index of a cell along one axis, clamped to the range of int64 (the
+//-- cast is undefined otherwise): very far points share the cells at the 
+//-- limits, their distances are still tested
+static int64 get_cell_index(double v, double size)
 {
-  std::string s;
-  if (_tol_snap < 0.0)
-  {
-    s = std::to_string(p->x()) + std::to_string(p->y()) + std::to_string(p->z());
-  }
-  else
+  double c = std::floor(v / size);
+  const double limit = 9.0e18;
+  if (std::isnan(c) == true)
+    return 0;
+  if (c > limit)
+    return int64(limit);
+  if (c < -limit)
+    return -int64(limit);
+  return int64(c);
+}
+
+
+GridCell Surface::get_grid_cell(const Point3& p)
+{
+  if (_tol_snap == 0.0)
   {
-    int tol = int(1 / _tol_snap);
-    s = std::to_string(int64(p->x() * tol)) + " " + std::to_string(int64(p->y() * tol)) + " " + std::to_string(int64(p->z() * tol));
+    //-- only identical points are merged: the cell is the point itself
+    //-- (+0.0 so that -0.0 and 0.0 are in the same cell)
+    double c[3] = { CGAL::to_double(p.x()) + 0.0, CGAL::to_double(p.y()) + 0.0, CGAL::to_double(p.z()) + 0.0 };
+    int64 k[3];
+    std::memcpy(k, c, sizeof(k));
+    return std::make_tuple(k[0], k[1], k[2]);
   }
-  return s;
+  //-- cells are slightly larger than tol_snap so that, even with the rounding
+  //-- of the division, 2 points closer than tol_snap are in adjacent cells
+  double size = std::abs(_tol_snap) * 1.0001;
+  return std::make_tuple(get_cell_index(CGAL::to_double(p.x()), size),
+                         get_cell_index(CGAL::to_double(p.y()), size),
+                         get_cell_index(CGAL::to_double(p.z()), size));
 }
 
 bool Surface::were_vertices_merged_during_parsing()
@@ -212,38 +278,153 @@ int Surface::get_number_parsed_vertices()
 int Surface::add_point(Point3 pi)
 {
   _vertices_added += 1;
-  int i = 0;
-  for (auto& p : _lsPts)
+  //-- pi is snapped to the stored point with the smallest id that is closer
+  //-- than tol_snap; only the 27 cells around pi can contain such points
+  GridCell c = get_grid_cell(pi);
+  int re = -1;
+  int r = (_tol_snap == 0.0) ? 0 : 1;
+  for (int64 dx = -r; dx <= r; dx++)
   {
-    auto d = CGAL::squared_distance(pi, p);
-    if (d <= (_tol_snap*_tol_snap))
-      return i;
-    i++;
+    for (int64 dy = -r; dy <= r; dy++)
+    {
+      for (int64 dz = -r; dz <= r; dz++)
+      {
+        auto it = _grid.find(std::make_tuple(std::get<0>(c) + dx, std::get<1>(c) + dy, std::get<2>(c) + dz));
+        if (it == _grid.end())
+          continue;
+        //-- ids in a cell are sorted
+        for (auto& i : it->second)
+        {
+          if ( (re != -1) && (i >= re) )
+            break;
+          if (CGAL::squared_distance(pi, _lsPts[i]) <= (_tol_snap*_tol_snap))
+          {
+            re = i;
+            break;
+          }
+        }
+      }
+    }
   }
+  if (re != -1)
+    return re;
   _lsPts.push_back(pi);
+  _grid[c].push_back(_lsPts.size() - 1);
   return (_lsPts.size() - 1);
 }
 
-// int Surface::add_point(Point3 p)
-// {
-//   _vertices_added += 1;
-//   auto it = _dPts.find(get_coords_key(&p));
-//   if (it == _dPts.end()) 
-//   {
-//     _lsPts.push_back(p);
-//     _dPts[get_coords_key(&p)] = (_lsPts.size() - 1); 
-//     return (_lsPts.size() - 1);
-//   }
-//   return it->second;
-// }
+int Surface::add_point(Point3 p, int vertexid)
+{
+  int re = this->add_point(p);
+  _dVertexIds[vertexid] = re;
+  return re;
+}
+
+
+//-- -1 if that vertex index wasn't added yet
+int Surface::get_point_id(int vertexid)
+{
+  auto it = _dVertexIds.find(vertexid);
+  if (it == _dVertexIds.end())
+    return -1;
+  _vertices_added += 1;
+  return it->second;
+}
+
 
 void Surface::add_face(std::vector< std::vector<int> > f, std::string id)
 {
-  _lsFaces.push_back(f);
-  if (id.empty() == true)
-    _lsFacesID.push_back(std::to_string(_lsFaces.size()));
-  else
-    _lsFacesID.push_back(id);
+  this->add_face(id);
+  for (auto& r : f)
+  {
+    this->add_ring();
+    for (auto& i : r)
+      this->add_ring_vertex(i);
+  }
+}
+
+
+void Surface::add_face(std::string id)
+{
+  _lsFaceOffsets.push_back(_lsFaceOffsets.back());
+  if (id.empty() == false)
+    _dFacesID[this->number_faces() - 1] = id;
+}
+
+
+//-- no reserve() here: reserving the exact size of each ring would reallocate
+//-- (and copy) the whole buffer for each ring, push_back() grows it geometrically
+void Surface::add_ring()
+{
+  _lsRingOffsets.push_back(_lsRingOffsets.back());
+  _lsFaceOffsets.back() += 1;
+}
+
+
+void Surface::add_ring_vertex(int id)
+{
+  _lsRingVertices.push_back(id);
+  _lsRingOffsets.back() += 1;
+}
+
+
+int Surface::number_rings(int face) const
+{
+  return _lsFaceOffsets[face + 1] - _lsFaceOffsets[face];
+}
+
+
+RingView Surface::get_ring(int face, int ring) const
+{
+  int r = _lsFaceOffsets[face] + ring;
+  const int* ids = _lsRingVertices.data();
+  return RingView{ ids + _lsRingOffsets[r], ids + _lsRingOffsets[r + 1] };
+}
+
+
+//-- the vertices of the face are projected on its plane, once
+void Surface::project_face(int face, const CgalPolyhedron::Plane_3& plane)
+{
+  int first = _lsRingOffsets[_lsFaceOffsets[face]];
+  int last = _lsRingOffsets[_lsFaceOffsets[face + 1]];
+  for (int k = first; k < last; k++)
+    _lsProjected[k] = plane.to_2d(_lsPts[_lsRingVertices[k]]);
+}
+
+
+Polygon Surface::get_projected_ring(int face, int ring) const
+{
+  int r = _lsFaceOffsets[face] + ring;
+  return Polygon(_lsProjected.begin() + _lsRingOffsets[r], _lsProjected.begin() + _lsRingOffsets[r + 1]);
+}
+
+
+//-- strictly convex: all the turns are in the same direction, and none is 
+//-- collinear (the ring is simple, this was validated before)
+bool Surface::is_projected_ring_convex(int face, int ring) const
+{
+  int r = _lsFaceOffsets[face] + ring;
+  int n = _lsRingOffsets[r + 1] - _lsRingOffsets[r];
+  const Point2* p = _lsProjected.data() + _lsRingOffsets[r];
+  CGAL::Orientation o = CGAL::orientation(p[n - 1], p[0], p[1]);
+  if (o == CGAL::COLLINEAR)
+    return false;
+  for (int k = 1; k < n; k++)
+  {
+    if (CGAL::orientation(p[k - 1], p[k], p[(k + 1) % n]) != o)
+      return false;
+  }
+  return true;
+}
+
+
+//-- the id of a face is only made when an error is reported
+std::string Surface::get_face_id(int face) const
+{
+  auto it = _dFacesID.find(face);
+  if (it != _dFacesID.end())
+    return it->second;
+  return std::to_string(face + 1);
 }
 
 
@@ -255,7 +436,7 @@ int Surface::number_vertices()
 
 int Surface::number_faces()
 {
-  return _lsFaces.size();
+  return static_cast<int>(_lsFaceOffsets.size()) - 1;
 }
 
 
@@ -263,131 +444,77 @@ bool Surface::triangulate_shell()
 {
   std::clog << "-----Triangulation of each surface" << std::endl;
   //-- read the facets
-  size_t num = _lsFaces.size();
-  for (int i = 0; i < static_cast<int>(num); i++)
+  int num = this->number_faces();
+  for (int i = 0; i < num; i++)
   {
     // These are the number of rings on this facet
-    size_t numf = _lsFaces[i].size();
-    std::vector<int> &idsob = _lsFaces[i][0]; // helpful alias for the outer boundary
+    int numf = this->number_rings(i);
+    RingView idsob = this->get_ring(i, 0); // helpful alias for the outer boundary
     if ( (numf == 1) && (idsob.size() == 3)) 
     {
-      std::vector<int*> oneface;
-      int* tr = new int[3];
-      tr[0] = idsob[0] ;
-      tr[1] = idsob[1];
-      tr[2] = idsob[2];
-      oneface.push_back(tr);
-      _lsTr.push_back(oneface);
+      _lsTr.push_back(TriangleIds{ {idsob[0], idsob[1], idsob[2]} });
+      _lsTrOffsets.push_back(static_cast<int>(_lsTr.size()));
       continue;
     }
-    
-    std::vector<Point3> allpts;
-    std::vector<int>::const_iterator itp = idsob.begin();
-    for ( ; itp != idsob.end(); itp++)
-      allpts.push_back(_lsPts[*itp]);
-    //-- irings
-    for (int j = 1; j < static_cast<int>(numf); j++)
+    //-- a convex face without holes (most of them: rectangles, roof faces, etc.)
+    //-- is triangulated with a fan, the triangles keep the orientation of the ring
+    if ( (numf == 1) && (is_projected_ring_convex(i, 0) == true) )
     {
-      std::vector<int> &ids2 = _lsFaces[i][j]; // helpful alias for the inner boundary
-      std::vector<int>::const_iterator itp2 = ids2.begin();
-      for ( ; itp2 != ids2.end(); itp2++)
-        allpts.push_back(_lsPts[*itp2]);
+      for (size_t k = 1; (k + 1) < idsob.size(); k++)
+        _lsTr.push_back(TriangleIds{ {idsob[0], idsob[k], idsob[k + 1]} });
+      _lsTrOffsets.push_back(static_cast<int>(_lsTr.size()));
+      continue;
     }
-    CgalPolyhedron::Plane_3 bestfitplane = get_best_fitted_plane(allpts);
     
-    // int proj = projection_plane(_lsPts, idsob);
-    // Vector v0 = bestfitplane.orthogonal_vector();
-
-    //-- get projected Polygon
-    Polygon pgn;
-    std::vector<Polygon> lsRings;
-    create_cgal_polygon(_lsPts, idsob, bestfitplane, pgn);
+    //-- the plane and the projection are those of the 2D validation
     //-- all polygons should be cw for Triangle
     //-- if reversed then re-reversed later
-    bool reversed = false;
-    if (pgn.is_counterclockwise_oriented() == false) {
-      pgn.reverse_orientation();
-      reversed = true;
-    }
-    lsRings.push_back(pgn);
-    std::vector< std::vector<int> > pgnids;
-    pgnids.push_back(idsob);
-    //-- check for irings
-    for (int j = 1; j < static_cast<int>(numf); j++)
-    {
-      std::vector<int> &ids2 = _lsFaces[i][j]; // helpful alias for the inner boundary
-      //-- get projected Polygon
-      Polygon pgn;
-      create_cgal_polygon(_lsPts, ids2, bestfitplane, pgn);
-      if (pgn.is_counterclockwise_oriented() == false) {
-        pgn.reverse_orientation();
-      }
-      lsRings.push_back(pgn);
-      pgnids.push_back(ids2);
-    }
+    int r0 = _lsRingOffsets[_lsFaceOffsets[i]];
+    bool reversed = (CGAL::orientation_2(_lsProjected.begin() + r0, 
+                                         _lsProjected.begin() + r0 + idsob.size(), 
+                                         K()) != CGAL::COUNTERCLOCKWISE);
     //-- get projected CT
-    std::vector<int*> oneface;
-    if (construct_ct(pgnids, lsRings, oneface, i, bestfitplane) == false)
+    size_t first = _lsTr.size();
+    if (construct_ct(i) == false)
     {
-      this->add_error(999, _lsFacesID[i], "face does not have an outer boundary.");
+      _lsTr.resize(first);
+      this->add_error(999, this->get_face_id(i), "face does not have an outer boundary.");
       return false;
     }
     if (reversed == true) //-- reversed back to keep orientation of original surface
     {
-      std::vector<int*>::iterator it3 = oneface.begin();
-      int tmp;
-      int* id;
-      for ( ; it3 != oneface.end(); it3++)
-      {
-        id = *it3;
-        tmp = id[0];
-        id[0] = id[1];
-        id[1] = tmp;
-      }
+      for (size_t k = first; k < _lsTr.size(); k++)
+        std::swap(_lsTr[k][0], _lsTr[k][1]);
     }
-    _lsTr.push_back(oneface);
+    _lsTrOffsets.push_back(static_cast<int>(_lsTr.size()));
   }
   return true;
 }
 
 
-bool Surface::construct_ct(const std::vector< std::vector<int> >& pgnids, const std::vector<Polygon>& lsRings, std::vector<int*>& oneface, int faceNum, const CgalPolyhedron::Plane_3 &plane)
+//-- the triangles of the face are appended to _lsTr
+bool Surface::construct_ct(int face)
 {
-  std::vector<int> ids = pgnids[0];
   CT ct;
-  std::vector< std::vector<int> >::const_iterator it = pgnids.begin();
-  size_t numpts = 0;
-  for ( ; it != pgnids.end(); it++)
+  for (int j = 0; j < this->number_rings(face); j++)
   {
-    numpts += it->size();
-  }
-  for ( it = pgnids.begin(); it != pgnids.end(); it++)
-  {
-    std::vector<Point2> pts2d;
-    std::vector<int>::const_iterator it2 = it->begin();
-    for ( ; it2 != it->end(); it2++)
-    {
-      Point3 p1 = _lsPts[*it2];
-      pts2d.push_back(plane.to_2d(p1));
-    }
-    std::vector<Point2>::const_iterator itPt;
+    RingView r = this->get_ring(face, j);
+    const int* it2 = r.begin();
+    const Point2* itPt = _lsProjected.data() + _lsRingOffsets[_lsFaceOffsets[face] + j];
     CT::Vertex_handle v0;
     CT::Vertex_handle v1;
     CT::Vertex_handle firstv;
-    itPt = pts2d.begin();
     v0 = ct.insert(*itPt);
     firstv = v0;
-    it2 = it->begin();
     v0->id() = *it2;
-    itPt++;
     it2++;
-    for (; itPt != pts2d.end(); itPt++)
+    itPt++;
+    for (; it2 != r.end(); it2++, itPt++)
     {
       v1 = ct.insert(*itPt);
       v1->id() = *it2;
       ct.insert_constraint(v0, v1);
       v0 = v1;
-      it2++;
     }
     ct.insert_constraint(v0,firstv);
   }
@@ -400,13 +527,8 @@ bool Surface::construct_ct(const std::vector< std::vector<int> >& pgnids, const
        fit != ct.finite_faces_end(); 
        ++fit) 
   {
-    if (fit->info().in_domain()) {
-      int* tr = new int[3];
-      tr[0] = fit->vertex(0)->id();
-      tr[1] = fit->vertex(1)->id();
-      tr[2] = fit->vertex(2)->id();
-      oneface.push_back(tr);
-    }
+    if (fit->info().in_domain())
+      _lsTr.push_back(TriangleIds{ {fit->vertex(0)->id(), fit->vertex(1)->id(), fit->vertex(2)->id()} });
   }
   return true;
 }
@@ -434,105 +556,113 @@ void Surface::translate_vertices()
   std::vector<Point3>::iterator it = _lsPts.begin();
   for (it = _lsPts.begin(); it != _lsPts.end(); it++)
   {
-    Point3 tp(CGAL::to_double(it->x() - Surface::_shiftx), CGAL::to_double(it->y() - Surface::_shifty), CGAL::to_double(it->z()));
+    Point3 tp(CGAL::to_double(it->x() - _shiftx), CGAL::to_double(it->y() - _shifty), CGAL::to_double(it->z()));
     *it = tp;
   }
-}
-
-
-void Surface::set_translation_min_values(double minx, double miny)
-{
-  Surface::_shiftx = minx;
-  Surface::_shifty = miny;
+  //-- the grid is rebuilt only if the parsing is not over
+  if (_grid.empty() == false)
+  {
+    _grid.clear();
+    for (int i = 0; i < _lsPts.size(); i++)
+      _grid[get_grid_cell(_lsPts[i])].push_back(i);
+  }
 }
 
 
 bool Surface::validate_2d_primitives(double tol_planarity_d2p, double tol_planarity_normals)
 {
   std::clog << "-----2D validation of each surface" << std::endl;
+  //-- the parsing is over: the snapping grid and the vertex ids are freed
+  std::unordered_map<GridCell, std::vector<int>, GridCellHash>().swap(_grid);
+  std::unordered_map<int, int>().swap(_dVertexIds);
   bool isValid = true;
-  size_t num = _lsFaces.size();
-  for (int i = 0; i < static_cast<int>(num); i++)
+  int num = this->number_faces();
+  _lsProjected.resize(_lsRingVertices.size());
+  //-- the planarity of all the faces is first tested with the pre-filters,
+  //-- CGAL only for the faces flagged
+  //-- the rings of a face are contiguous in _lsRingVertices
+  auto get_face_points = [&](int i) {
+    std::vector< Point3 > allpts;
+    for (int k = _lsRingOffsets[_lsFaceOffsets[i]]; k < _lsRingOffsets[_lsFaceOffsets[i + 1]]; k++)
+      allpts.push_back(_lsPts[_lsRingVertices[k]]);
+    return allpts;
+  };
+  std::vector<CgalPolyhedron::Plane_3> planes(num, CgalPolyhedron::Plane_3(0, 0, 0, 0));
+  std::vector<char> fitted(num, 0);
+  for (int i = 0; i < num; i++)
   {
     //-- test for too few points (<3 for a ring)
-    if (has_face_rings_toofewpoints(_lsFaces[i]) == true)
+    if (has_face_rings_toofewpoints(i) == true)
     {
-      this->add_error(101, _lsFacesID[i]);
+      this->add_error(101, this->get_face_id(i));
       isValid = false;
       continue;
     }
     //-- test for 2 repeated consecutive points
-    if (has_face_2_consecutive_repeated_pts(_lsFaces[i]) == true)
+    if (has_face_2_consecutive_repeated_pts(i) == true)
     {
-      this->add_error(102, _lsFacesID[i]);
+      this->add_error(102, this->get_face_id(i));
       isValid = false;
       continue;
     }
-    size_t numf = _lsFaces[i].size();
-    std::vector<int> &ids = _lsFaces[i][0]; // helpful alias for the outer boundary
+    int numf = this->number_rings(i);
+    RingView ids = this->get_ring(i, 0); // helpful alias for the outer boundary
 
     //-- if only 3 pts it's not valid, no need to process further
     if ( (numf == 1) && (ids.size() == 3)) 
     {
       if (CGAL::collinear(_lsPts[ids[0]], _lsPts[ids[1]], _lsPts[ids[2]]) == true) {
-        this->add_error(104, _lsFacesID[i], " outer ring (a triangle) is collapsed to a line");
+        this->add_error(104, this->get_face_id(i), " outer ring (a triangle) is collapsed to a line");
         isValid = false;
       }
       continue;
     }
 
-    std::vector< Point3 > allpts;
-    std::vector<int>::const_iterator itp = ids.begin();
-    for ( ; itp != ids.end(); itp++)
-    {
-      allpts.push_back(_lsPts[*itp]);
-    }
-    //-- irings
-    for (int j = 1; j < static_cast<int>(numf); j++)
-    {
-      std::vector<int> &ids2 = _lsFaces[i][j]; // helpful alias for the inner boundary
-      std::vector<int>::const_iterator itp2 = ids2.begin();
-      for ( ; itp2 != ids2.end(); itp2++)
-      {
-        allpts.push_back(_lsPts[*itp2]);
-      }
-    }
+    planes[i] = get_best_fitted_plane(get_face_points(i));
+    fitted[i] = 1;
+  }
+  std::vector<char> flags;
+  flag_faces_distance2plane(_lsPts, _lsRingVertices, _lsRingOffsets, _lsFaceOffsets, planes, tol_planarity_d2p, flags);
+  for (int i = 0; i < num; i++)
+  {
+    if (fitted[i] == 0)
+      continue;
+    int numf = this->number_rings(i);
     double value;
-    CgalPolyhedron::Plane_3 bestfitplane = get_best_fitted_plane(allpts);
-    if (false == is_face_planar_distance2plane(allpts, bestfitplane, value, tol_planarity_d2p))
+    const CgalPolyhedron::Plane_3& bestfitplane = planes[i];
+    if ( (flags[i] == 1) && (false == is_face_planar_distance2plane(get_face_points(i), bestfitplane, value, tol_planarity_d2p)) )
     {
       std::stringstream msg;
       msg << "distance to fitted plane: " << value << " (tolerance=" << tol_planarity_d2p << ")";
-      this->add_error(203, _lsFacesID[i], msg.str());
+      this->add_error(203, this->get_face_id(i), msg.str());
       isValid = false;
       continue;
     }
     //-- get projected oring
-    Polygon pgn;
+    project_face(i, bestfitplane);
+    Polygon pgn = get_projected_ring(i, 0);
     std::vector<Polygon> lsRings;
-    create_cgal_polygon(_lsPts, ids, bestfitplane, pgn);
-    if (validate_projected_ring(pgn, _lsFacesID[i]) == false)
+    //-- the native engine tests the simplicity of the rings itself
+    if ( (_polygon_engine == ENGINE_GEOS) && (validate_projected_ring(pgn, this->get_face_id(i)) == false) )
     {
       isValid = false;
       continue;
     }
     lsRings.push_back(pgn);
     //-- check for irings
-    for (int j = 1; j < static_cast<int>(numf); j++)
+    for (int j = 1; j < numf; j++)
     {
-      std::vector<int> &ids2 = _lsFaces[i][j]; // helpful alias for the inner boundary
       //-- get projected iring
-      Polygon pgn;
-      create_cgal_polygon(_lsPts, ids2, bestfitplane, pgn);
-      if (validate_projected_ring(pgn, _lsFacesID[i]) == false)
+      Polygon pgn = get_projected_ring(i, j);
+      if ( (_polygon_engine == ENGINE_GEOS) && (validate_projected_ring(pgn, this->get_face_id(i)) == false) )
       {
         isValid = false;
         continue;
       }
       lsRings.push_back(pgn);
     }
-    //-- use GEOS to validate projected polygon
-    if (!validate_polygon(lsRings, _lsFacesID[i]))
+    //-- use GEOS (or the native engine) to validate projected polygon
+    if (!validate_polygon(lsRings, this->get_face_id(i)))
       isValid = false;
   }
   if (isValid)
@@ -541,21 +671,25 @@ bool Surface::validate_2d_primitives(double tol_planarity_d2p, double tol_planar
     triangulate_shell();
     //-- check planarity by normal deviation method (of all triangle)
     std::clog << "-----Planarity of surfaces (with normals deviation)" << std::endl;
-    std::vector< std::vector<int*> >::iterator it = _lsTr.begin();
-    int j = 0;
     double deviation;
-    for ( ; it != _lsTr.end(); it++)
+    flag_faces_normals(_lsPts, _lsTr, _lsTrOffsets, tol_planarity_normals, flags);
+    for (int j = 0; j < static_cast<int>(_lsTrOffsets.size()) - 1; j++)
     { 
-      if (is_face_planar_normals(*it, _lsPts, deviation, tol_planarity_normals) == false)
+      if (flags[j] == 0)
+        continue;
+      const TriangleIds* first = _lsTr.data() + _lsTrOffsets[j];
+      const TriangleIds* last = _lsTr.data() + _lsTrOffsets[j + 1];
+      if (is_face_planar_normals(first, last, _lsPts, deviation, tol_planarity_normals) == false)
       {
         std::ostringstream msg;
         msg << "deviation normals: " << deviation << " (tolerance=" << tol_planarity_normals << ")";
-        this->add_error(204, _lsFacesID[j], msg.str());
+        this->add_error(204, this->get_face_id(j), msg.str());
         isValid = false;
       }
-      j++;
     }
   }
+  //-- the projections are not needed anymore
+  std::vector<Point2>().swap(_lsProjected);
   _is_valid_2d = isValid;
   return isValid;
 }
@@ -592,116 +726,429 @@ bool Surface::validate_as_compositesurface(double tol_planarity_d2p, double tol_
     return false;
 //-- 2. Combinatorial consistency
   std::clog << "--Combinatorial consistency" << std::endl;
-  _polyhedron = construct_CgalPolyhedron_incremental(&(_lsTr), &(_lsPts), this);
-  if (this->has_errors() == true)
+  if (_auto_orient == true)
+    orient_faces();
+  if (precheck_combinatorics(false) == false)
     return false;
-  if (_polyhedron != NULL)
+  //-- the precheck found all the combinatorial errors, the mesh is only built
+  //-- for the geometric queries
+  _mesh = construct_CgalMesh(_lsTr, _lsPts);
+  if (_mesh == NULL)
   {
-    if (_polyhedron->is_valid() == true)
+    this->add_error(300, "", "Something went wrong during construction of the shell, reason is unknown.");
+    return false;
+  }
+//-- 2. Geometrical consistency (aka intersection tests between faces)
+  std::clog << "--Geometrical consistency" << std::endl;
+  if (does_self_intersect() == false)
+    return false;
+  return true;
+}
+
+
+//-- the "auto-orient" pre-pass: the faces are flipped so that 2 adjacent 
+//-- faces use their shared edge in opposite directions. The directed edges 
+//-- are hashed, and a BFS over the adjacent faces starts from the first face 
+//-- of each component. The orientation of a component is then the one of 
+//-- the majority of its area: if the faces to flip are larger than the 
+//-- others, the others are flipped instead (the first face is thus not 
+//-- trusted more than the others). Only the edges with exactly 2 
+//-- triangles propagate the orientation, the other errors (and the faces 
+//-- that cannot be oriented consistently) are left to the precheck.
+//-- The triangles of a face are flipped together, its rings are kept as given.
+int Surface::orient_faces()
+{
+  int64 nv = static_cast<int64>(_lsPts.size());
+  int ntr = static_cast<int>(_lsTr.size());
+  int nf = static_cast<int>(_lsTrOffsets.size()) - 1;
+  std::vector<int> trface(ntr);
+  for (int f = 0; f < nf; f++)
+    for (int t = _lsTrOffsets[f]; t < _lsTrOffsets[f + 1]; t++)
+      trface[t] = f;
+  //-- undirected edge -> the corners (3*triangle + position of the source
+  //-- vertex) using it, the first 2 are kept
+  struct EdgeUse { int c0; int c1; int n; };
+  std::unordered_map<int64, EdgeUse> edges;
+  edges.reserve(3 * ntr);
+  for (int c = 0; c < 3 * ntr; c++)
+  {
+    int a = _lsTr[c / 3][c % 3];
+    int b = _lsTr[c / 3][(c % 3 + 1) % 3];
+    int64 key = std::min(a, b) * nv + std::max(a, b);
+    auto it = edges.find(key);
+    if (it == edges.end())
+      edges[key] = EdgeUse{c, -1, 1};
+    else
     {
-      if (_polyhedron->keep_largest_connected_components(1) > 0)
+      if (it->second.n == 1)
+        it->second.c1 = c;
+      it->second.n++;
+    }
+  }
+  //-- -1: not reached; 0: kept; 1: flipped
+  std::vector<char> state(nf, -1);
+  std::vector<int> front;
+  int noflipped = 0;
+  for (int seed = 0; seed < nf; seed++)
+  {
+    if (state[seed] != -1)
+      continue;
+    state[seed] = 0;
+    front.push_back(seed);
+    size_t cur = front.size() - 1;
+    while (cur < front.size())
+    {
+      int f = front[cur++];
+      for (int c = 3 * _lsTrOffsets[f]; c < 3 * _lsTrOffsets[f + 1]; c++)
       {
-        this->add_error(305);
-        return false;
+        int a = _lsTr[c / 3][c % 3];
+        int b = _lsTr[c / 3][(c % 3 + 1) % 3];
+        const EdgeUse& e = edges[std::min(a, b) * nv + std::max(a, b)];
+        if (e.n != 2)
+          continue;
+        int o = (e.c0 == c) ? e.c1 : e.c0;
+        int g = trface[o / 3];
+        if ( (g == f) || (state[g] != -1) )
+          continue;
+        //-- same direction: g must be flipped relative to f
+        bool samedir = (_lsTr[o / 3][o % 3] == a);
+        state[g] = state[f] ^ (samedir ? 1 : 0);
+        front.push_back(g);
       }
     }
-    else 
+    double area[2] = {0.0, 0.0};
+    for (auto& f : front)
+      for (int t = _lsTrOffsets[f]; t < _lsTrOffsets[f + 1]; t++)
+        area[int(state[f])] += std::sqrt(CGAL::to_double(Triangle(_lsPts[_lsTr[t][0]], _lsPts[_lsTr[t][1]], _lsPts[_lsTr[t][2]]).squared_area()));
+    char invert = (area[1] > area[0]) ? 1 : 0;
+    for (auto& f : front)
     {
-      this->add_error(300, "", "Something went wrong during construction of the shell, reason is unknown.");
-      return false;
+      state[f] ^= invert;
+      if (state[f] == 1)
+        noflipped++;
     }
-    //-- check for non-manifold vertices
-    //-- errors will be added to the Surface
-    this->contains_nonmanifold_vertices();
+    front.clear();
   }
-  else
+  for (int f = 0; f < nf; f++)
+    if (state[f] == 1)
+      for (int t = _lsTrOffsets[f]; t < _lsTrOffsets[f + 1]; t++)
+        std::swap(_lsTr[t][1], _lsTr[t][2]);
+  std::clog << "Auto-orient: " << noflipped << " face(s) flipped" << std::endl;
+  return noflipped;
+}
+
+
+//-- the combinatorial errors are found with the triangles only, before the 
+//-- mesh is built (only the surfaces passing are built):
+//--   1. the triangles are added in their order to a hash table of directed 
+//--      edges; one whose edge is already used is rejected, 307 if its 
+//--      reverse could be added, 303 otherwise
+//--   2. the corners of the triangles around each vertex must form one fan 
+//--      (303; for a shell, not if all the fans are on the border), and the 
+//--      triangles one component (305, for each face outside the largest one)
+//--   3. a shell has no border edges (302, one error per hole)
+bool Surface::precheck_combinatorics(bool isshell)
+{
+  int64 nv = static_cast<int64>(_lsPts.size());
+  int ntr = static_cast<int>(_lsTr.size());
+  //-- directed edge -> corner (3*triangle + position of the source vertex)
+  std::unordered_map<int64, int> edges;
+  edges.reserve(3 * ntr);
+  auto key = [&](int a, int b) { return (static_cast<int64>(a) * nv) + b; };
+  bool conflict = false;
+  for (int f = 0; f < static_cast<int>(_lsTrOffsets.size()) - 1; f++)
   {
-    this->add_error(300, "", "Something went wrong during construction of the shell, reason is unknown.");
+    for (int t = _lsTrOffsets[f]; t < _lsTrOffsets[f + 1]; t++)
+    {
+      const TriangleIds& tr = _lsTr[t];
+      bool used = false;
+      bool usedreversed = false;
+      for (int k = 0; k < 3; k++)
+      {
+        used |= (edges.count(key(tr[k], tr[(k + 1) % 3])) > 0);
+        usedreversed |= (edges.count(key(tr[(k + 1) % 3], tr[k])) > 0);
+      }
+      if (used == false)
+      {
+        for (int k = 0; k < 3; k++)
+          edges[key(tr[k], tr[(k + 1) % 3])] = (3 * t) + k;
+      }
+      else
+      {
+        conflict = true;
+        this->add_error((usedreversed == false) ? 307 : 303, this->get_face_id(f));
+      }
+    }
+  }
+  if (conflict == true)
+    return false;
+  //-- corners linked around their vertex, and triangles linked by their edges
+  std::vector<int> corners(3 * ntr);
+  std::vector<int> triangles(ntr);
+  std::iota(corners.begin(), corners.end(), 0);
+  std::iota(triangles.begin(), triangles.end(), 0);
+  auto find_root = [](std::vector<int>& parents, int i) {
+    while (parents[i] != i)
+    {
+      parents[i] = parents[parents[i]];
+      i = parents[i];
+    }
+    return i;
+  };
+  std::vector<int> border;
+  for (int t = 0; t < ntr; t++)
+  {
+    const TriangleIds& tr = _lsTr[t];
+    for (int k = 0; k < 3; k++)
+    {
+      auto it = edges.find(key(tr[(k + 1) % 3], tr[k]));
+      if (it == edges.end())
+      {
+        border.push_back((3 * t) + k);
+        continue;
+      }
+      //-- the twin goes to tr[k], the corner after its source
+      int other = ((it->second / 3) * 3) + (((it->second % 3) + 1) % 3);
+      corners[find_root(corners, (3 * t) + k)] = find_root(corners, other);
+      triangles[find_root(triangles, t)] = find_root(triangles, it->second / 3);
+    }
+  }
+  //-- the components in the same sweep, the mesh is never modified: the 
+  //-- faces outside the largest component are reported
+  std::vector<int> sizes(ntr, 0);
+  int ncomponents = 0;
+  int largest = -1;
+  for (int t = 0; t < ntr; t++)
+  {
+    int r = find_root(triangles, t);
+    if (sizes[r]++ == 0)
+      ncomponents++;
+    if ( (largest == -1) || (sizes[r] > sizes[largest]) )
+      largest = r;
+  }
+  auto report_disconnected_faces = [&]() {
+    std::string info = std::to_string(ncomponents) + " connected components, the face is not in the largest one.";
+    for (int f = 0; f < static_cast<int>(_lsTrOffsets.size()) - 1; f++)
+    {
+      if ( (_lsTrOffsets[f] < _lsTrOffsets[f + 1]) && (find_root(triangles, _lsTrOffsets[f]) != largest) )
+        this->add_error(305, this->get_face_id(f), info);
+    }
+  };
+  auto location = [&](int v) {
+    std::stringstream st;
+    st << "(" << (_lsPts[v].x() + _shiftx) << ", " << (_lsPts[v].y() + _shifty) << ", " << _lsPts[v].z() << ")";
+    return st.str();
+  };
+  //-- a CompositeSurface made of parts touching at a vertex has several components
+  if ( (isshell == false) && (ncomponents > 1) )
+  {
+    report_disconnected_faces();
     return false;
   }
+  //-- the corners around a vertex must be in one fan (303). For a shell, a
+  //-- vertex where all the fans are open (on the border) is not reported:
+  //-- it is on the border of holes, reported as such (302)
+  std::vector<bool> openfan(3 * ntr, false);
+  for (auto& c : border)
+    openfan[find_root(corners, c)] = true;
+  std::vector<int> fan(nv, -1);
+  std::vector<bool> severalfans(nv, false);
+  std::vector<bool> closedfan(nv, false);
+  for (int c = 0; c < 3 * ntr; c++)
+  {
+    int v = _lsTr[c / 3][c % 3];
+    int r = find_root(corners, c);
+    if (openfan[r] == false)
+      closedfan[v] = true;
+    if (fan[v] == -1)
+      fan[v] = r;
+    else if (fan[v] != r)
+      severalfans[v] = true;
+  }
+  for (int64 v = 0; v < nv; v++)
+  {
+    if ( (severalfans[v] == true) && ( (isshell == false) || (closedfan[v] == true) ) )
+      this->add_error(303, "", "Non-manifold vertex at " + location(v));
+  }
   if (this->has_errors() == true)
     return false;
-//-- 2. Geometrical consistency (aka intersection tests between faces)
-  std::clog << "--Geometrical consistency" << std::endl;
-  if (does_self_intersect() == false)
+  if ( (isshell == false) || ( (border.empty() == true) && (ncomponents == 1) ) )
+    return true;
+  if (ncomponents > 1)
+  {
+    report_disconnected_faces();
     return false;
-  return true;
+  }
+  //-- the holes: each border cycle is walked once, a border edge is followed
+  //-- by one starting at its target that is not visited yet, linear in the
+  //-- number of border edges. The border edges are sorted by their source
+  //-- vertex, a vertex can start several of them (if the border touches
+  //-- itself there)
+  std::vector<int> outoffsets(nv + 1, 0);
+  for (auto& c : border)
+    outoffsets[_lsTr[c / 3][c % 3] + 1]++;
+  for (int64 v = 0; v < nv; v++)
+    outoffsets[v + 1] += outoffsets[v];
+  std::vector<int> outedges(border.size());
+  std::vector<int> nextout(outoffsets.begin(), outoffsets.end() - 1);
+  for (int i = 0; i < static_cast<int>(border.size()); i++)
+    outedges[nextout[_lsTr[border[i] / 3][border[i] % 3]]++] = i;
+  //-- nextout[v]: the first border edge starting at v that can be unvisited
+  std::copy(outoffsets.begin(), outoffsets.end() - 1, nextout.begin());
+  std::vector<char> visited(border.size(), 0);
+  for (int i = 0; i < static_cast<int>(border.size()); i++)
+  {
+    if (visited[i] == 1)
+      continue;
+    int noedges = 0;
+    double length = 0.0;
+    int cur = i;
+    while (cur != -1)
+    {
+      visited[cur] = 1;
+      int c = border[cur];
+      int t = _lsTr[c / 3][((c % 3) + 1) % 3];
+      length += std::sqrt(CGAL::squared_distance(_lsPts[_lsTr[c / 3][c % 3]], _lsPts[t]));
+      noedges++;
+      while ( (nextout[t] < outoffsets[t + 1]) && (visited[outedges[nextout[t]]] == 1) )
+        nextout[t]++;
+      cur = (nextout[t] < outoffsets[t + 1]) ? outedges[nextout[t]] : -1;
+    }
+    std::stringstream st;
+    st << "Location hole: " << location(_lsTr[border[i] / 3][border[i] % 3]);
+    st << "; boundary of " << noedges << " edges, length " << length;
+    this->add_error(302, "", st.str());
+  }
+  return false;
 }
 
 
-bool Surface::contains_nonmanifold_vertices()
+//-- a face index is not a handle (it cannot be dereferenced for the id of the
+//-- box), the ids are explicit since box_self_intersection_d() copies the boxes
+typedef CGAL::Box_intersection_d::Box_with_info_d<double, 3, CgalMesh::Face_index,
+                                                  CGAL::Box_intersection_d::ID_EXPLICIT> FacetBox;
+typedef std::pair<CgalMesh::Face_index, CgalMesh::Face_index>     FacetPair;
+
+static Triangle get_mesh_triangle(const CgalMesh& m, CgalMesh::Halfedge_index h)
+{
+  return Triangle(m.point(m.target(h)), 
+                  m.point(m.target(m.next(h))), 
+                  m.point(m.target(m.next(m.next(h)))));
+}
+
+//-- same tests as PMP::self_intersections(): 2 triangles sharing an edge 
+//-- intersect only if they are folded onto each other, 2 sharing a vertex 
+//-- only if the opposite edge of one intersects the other
+static bool do_facets_intersect(const CgalMesh& m, CgalMesh::Face_index f1, CgalMesh::Face_index f2)
 {
-  //-- check for non-manifold vertices (which oddly CGAL doesn't expose as a function)
-  //-- the trick is to check if a given vertex has >2 incident edges (not half-edges, but edges)
-  //-- that are border edges
-  // count border edges 
-  std::map<CgalPolyhedron::Vertex_handle, int> noincident;
-  for (CgalPolyhedron::Halfedge_handle heh = _polyhedron->halfedges_begin(); heh != _polyhedron->halfedges_end(); heh++)
+  CgalMesh::Halfedge_index h = m.halfedge(f1);
+  for (int i = 0; i < 3; i++)
   {
-    if (heh->is_border() == true)
+    CgalMesh::Halfedge_index o = m.opposite(h);
+    if ( (m.is_border(o) == false) && (m.face(o) == f2) )
     {
-      auto it = noincident.find(heh->vertex());
-      if (it == noincident.end())
-        noincident[heh->vertex()] = 1;
-      else
-        noincident[heh->vertex()] += 1;
-      it = noincident.find(heh->opposite()->vertex());
-      if (it == noincident.end())
-        noincident[heh->opposite()->vertex()] = 1;
-      else
-        noincident[heh->opposite()->vertex()] += 1;
+      const Point3& s = m.point(m.target(o));
+      const Point3& t = m.point(m.target(h));
+      const Point3& a = m.point(m.target(m.next(h)));
+      const Point3& b = m.point(m.target(m.next(o)));
+      return ( (CGAL::coplanar(t, a, s, b) == true) && 
+               (CGAL::coplanar_orientation(s, t, a, b) == CGAL::POSITIVE) );
     }
+    h = m.next(h);
   }
-  for (auto& v : noincident)
+  CgalMesh::Halfedge_index g = m.halfedge(f2);
+  bool shared = false;
+  for (int i = 0; (i < 3) && (shared == false); i++)
   {
-    if (v.second > 2)
+    for (int j = 0; j < 3; j++)
     {
-      std::stringstream st;
-      st << "Non-manifold vertex at (";;
-      st << (v.first->point().x() + _shiftx);
-      st << ", ";
-      st << (v.first->point().y() + _shifty);
-      st << ", ";
-      st << v.first->point().z();
-      st << ")";
-      this->add_error(303, "", st.str());
+      if (m.target(h) == m.target(g))
+      {
+        shared = true;
+        break;
+      }
+      g = m.next(g);
     }
+    if (shared == false)
+      h = m.next(h);
   }
-  return (this->has_errors());
+  Triangle t1 = get_mesh_triangle(m, h);
+  Triangle t2 = get_mesh_triangle(m, g);
+  if (shared == true)
+  {
+    K::Segment_3 s1(m.point(m.target(m.next(h))), m.point(m.target(m.next(m.next(h)))));
+    K::Segment_3 s2(m.point(m.target(m.next(g))), m.point(m.target(m.next(m.next(g)))));
+    return ( (CGAL::do_intersect(t1, s2) == true) || (CGAL::do_intersect(t2, s1) == true) );
+  }
+  return CGAL::do_intersect(t1, t2);
 }
 
+
+//-- one pass: the pairs of triangles whose bboxes overlap are collected in
+//-- batches of bounded size, each batch is tested (in parallel for large 
+//-- surfaces) when it is full
 bool Surface::does_self_intersect()
 {
-  if (CGAL::Polygon_mesh_processing::does_self_intersect(*_polyhedron) == true)
-  {
-    std::vector<std::pair<CgalPolyhedron::Facet_const_handle, CgalPolyhedron::Facet_const_handle> > intersected_tris;
-    CGAL::Polygon_mesh_processing::self_intersections(*_polyhedron, std::back_inserter(intersected_tris));
-    std::set<CgalPolyhedron::Facet_const_handle> uniquetr;
-    for (auto& each : intersected_tris)
+  const CgalMesh& m = *_mesh;
+  std::vector<FacetBox> boxes;
+  boxes.reserve(m.number_of_faces());
+  for (CgalMesh::Face_index f : m.faces())
+    boxes.push_back(FacetBox(get_mesh_triangle(m, m.halfedge(f)).bbox(), f));
+  const size_t batchsize = 65536;
+  const size_t chunk = 1024;
+  bool inparallel = ( (TaskScheduler::get_number_threads() > 1) && (static_cast<int>(boxes.size()) > _min_triangles_parallel) );
+  std::vector<FacetPair> candidates;
+  candidates.reserve(batchsize);
+  std::vector<char> intersect(batchsize, 0);
+  std::set<CgalMesh::Face_index> uniquetr;
+  auto test_pairs = [&](size_t first, size_t last) {
+    for (size_t k = first; k < last; k++)
+      intersect[k] = do_facets_intersect(m, candidates[k].first, candidates[k].second);
+  };
+  auto test_batch = [&]() {
+    if (inparallel == true)
     {
-      uniquetr.insert(each.first);
-      uniquetr.insert(each.second);
+      TaskScheduler::parallel_for((candidates.size() + chunk - 1) / chunk, [&](size_t c) {
+        test_pairs(c * chunk, std::min(candidates.size(), (c + 1) * chunk));
+      });
     }
-    for (auto& each : uniquetr)
+    else
+      test_pairs(0, candidates.size());
+    for (size_t k = 0; k < candidates.size(); k++)
     {
-      //-- report the triangle centroid, as an approximation of the intersection
-      //-- faster and less error-prone than reporting exact location
-      Point3 c = CGAL::centroid(each->halfedge()->vertex()->point(),
-                                each->halfedge()->next()->vertex()->point(),
-                                each->halfedge()->next()->next()->vertex()->point()); 
-      std::stringstream st;
-      st << "Location close to: (";
-      st << c.x() + _shiftx;
-      st << ", ";
-      st << c.y() + _shifty;
-      st << ", ";
-      st << c.z();
-      st << ")"; 
-      this->add_error(306, "", st.str());
+      if (intersect[k] == 1)
+      {
+        uniquetr.insert(candidates[k].first);
+        uniquetr.insert(candidates[k].second);
+      }
     }
-    return false;
+    candidates.clear();
+  };
+  CGAL::box_self_intersection_d(boxes.begin(), boxes.end(), 
+                                [&](const FacetBox& a, const FacetBox& b) { 
+                                  candidates.push_back(std::make_pair(a.info(), b.info())); 
+                                  if (candidates.size() == batchsize)
+                                    test_batch();
+                                });
+  test_batch();
+  if (uniquetr.empty() == true)
+    return true;
+  for (auto& each : uniquetr)
+  {
+    //-- report the triangle centroid, as an approximation of the intersection
+    //-- faster and less error-prone than reporting exact location
+    Point3 c = CGAL::centroid(get_mesh_triangle(m, m.halfedge(each)));
+    std::stringstream st;
+    st << "Location close to: (";
+    st << c.x() + _shiftx;
+    st << ", ";
+    st << c.y() + _shifty;
+    st << ", ";
+    st << c.z();
+    st << ")"; 
+    this->add_error(306, "", st.str());
   }
-  return true;
+  return false;
 }
 
 
@@ -713,71 +1160,22 @@ bool Surface::validate_as_shell(double tol_planarity_d2p, double tol_planarity_n
   if (_is_valid_2d == 0)
     return false;
 //-- 1. minimum number of faces = 4
-  if (_lsTr.size() < 4) 
+  if ( (_lsTrOffsets.size() - 1) < 4 ) 
   {
     this->add_error(301);
     return false;
   }
 //-- 2. Combinatorial consistency
   std::clog << "-----Combinatorial consistency" << std::endl;
-  _polyhedron = construct_CgalPolyhedron_incremental(&(_lsTr), &(_lsPts), this);
-  if (this->has_errors() == true)
+  if (_auto_orient == true)
+    orient_faces();
+  if (precheck_combinatorics(true) == false)
     return false;
-  if (_polyhedron != NULL)
-  {
-    if (_polyhedron->is_valid() == true)
-    {
-      if (_polyhedron->is_closed() == false)
-      {
-        _polyhedron->normalize_border();
-        //-- check for unconnected faces
-        if (_polyhedron->keep_largest_connected_components(1) > 0)
-        {
-          //TODO: how to report what face is not connected? a bitch of a problem...
-          this->add_error(305);
-          return false;
-        }
-        else
-        {
-          //-- check if there are holes in the surface
-          if (_polyhedron->is_closed() == false)
-          {
-            std::stringstream st;
-            _polyhedron->normalize_border();
-            while (_polyhedron->size_of_border_edges() > 0) {
-              CgalPolyhedron::Halfedge_handle he = ++(_polyhedron->border_halfedges_begin());
-              st << "Location hole: (";
-              st << (he->vertex()->point().x() + _shiftx);
-              st << ", ";
-              st << (he->vertex()->point().y() + _shifty);
-              st << ", ";
-              st << he->vertex()->point().z();
-              st << ")";
-              this->add_error(302, "", st.str());
-              st.str("");
-              _polyhedron->fill_hole(he);
-              _polyhedron->normalize_border();
-            }
-            return false;
-          }
-        }
-      }
-      else //-- check if >1 connected components exist (both valid)
-      {
-        if (_polyhedron->keep_largest_connected_components(1) > 0) 
-        {
-          this->add_error(305, "", "More than one connected components.");
-          return false;
-        }
-      }
-    }
-    else 
-    {
-      this->add_error(300, "", "Something went wrong during construction of the shell, reason is unknown.");
-      return false;
-    }
-  }
-  else
+  //-- the precheck found all the combinatorial errors (orientation, 
+  //-- non-manifoldness, components, holes), the mesh is only built for the 
+  //-- geometric queries
+  _mesh = construct_CgalMesh(_lsTr, _lsPts);
+  if (_mesh == NULL)
   {
     this->add_error(300, "", "Something went wrong during construction of the shell, reason is unknown.");
     return false;
@@ -803,7 +1201,15 @@ bool Surface::validate_projected_ring(Polygon &pgn, std::string id)
 
 bool Surface::validate_polygon(std::vector<Polygon> &lsRings, std::string polygonid)
 {
-  initGEOS(NULL, NULL);
+  if (_polygon_engine == ENGINE_NATIVE)
+  {
+    std::vector<Error> lsErrors;
+    if (validate_polygon_native(lsRings, lsErrors) == true)
+      return true;
+    for (auto& e : lsErrors)
+      this->add_error(e.errorcode, polygonid, e.info1);
+    return false;
+  }
   //-- check the orientation of the rings: oring != irings
   //-- we don't care about CCW or CW at this point, just opposite is important
   //-- GEOS doesn't do its job, so we have to do it here. Shame on you GEOS.
@@ -826,74 +1232,71 @@ bool Surface::validate_polygon(std::vector<Polygon> &lsRings, std::string polygo
   if (isvalid == false)
     return isvalid;
   //-- check 2D validity of the surface by (1) projecting them; (2) use GEOS IsValid()
-  stringstream wkt;
-  wkt << setprecision(15);
-  wkt << "POLYGON(";
-  std::vector<Polygon>::iterator it = lsRings.begin();
-  //-- oring
-  wkt << "(";
-  Polygon::Vertex_iterator vit = it->vertices_begin();
-  for ( ; vit != it->vertices_end(); vit++)
-  {
-    wkt << vit->x() << " " << vit->y() << ",";
-  }
-  vit = it->vertices_begin();
-  wkt << vit->x() << " " << vit->y() << ")";
-  it++;
-  //-- irings
-  for ( ; it != lsRings.end(); it++)
-  {
-    wkt << ", (";
-    it->reverse_orientation();
-    Polygon::Vertex_iterator vit = it->vertices_begin();
-    for ( ; vit != it->vertices_end(); vit++)
-    {
-      wkt << vit->x() << " " << vit->y() << ",";
-    }
-    vit = it->vertices_begin();
-    wkt << vit->x() << " " << vit->y() << ")";
-    it->reverse_orientation();
+  //-- the geometry is built from the coordinates directly, irings are reversed
+  GEOSContextHandle_t h = get_geos_handle();
+  GEOSGeometry* shell = create_geos_ring(h, lsRings[0], false);
+  std::vector<GEOSGeometry*> holes;
+  for (size_t i = 1; i < lsRings.size(); i++)
+    holes.push_back(create_geos_ring(h, lsRings[i], true));
+  GEOSGeometry* mygeom = NULL;
+  if ( (shell != NULL) && (std::find(holes.begin(), holes.end(), (GEOSGeometry*)NULL) == holes.end()) )
+    mygeom = GEOSGeom_createPolygon_r(h, shell, holes.data(), static_cast<unsigned int>(holes.size()));
+  else
+  {
+    if (shell != NULL)
+      GEOSGeom_destroy_r(h, shell);
+    for (auto& each : holes)
+      if (each != NULL)
+        GEOSGeom_destroy_r(h, each);
+  }
+  if (mygeom == NULL)
+  {
+    this->add_error(999, polygonid, "GEOS could not construct the polygon");
+    return false;
   }
-  wkt << ")";
-  GEOSWKTReader* r;
-  r = GEOSWKTReader_create();
-  GEOSGeometry* mygeom;
-  mygeom = GEOSWKTReader_read(r, wkt.str().c_str());
-  string reason = (string)GEOSisValidReason(mygeom);
-  if (reason.find("Valid Geometry") == string::npos)
+  char* reason = NULL;
+  GEOSGeometry* location = NULL;
+  char re = GEOSisValidDetail_r(h, mygeom, 0, &reason, &location);
+  if (re != 1)
   {
     isvalid = false;
-    if (reason.find("Self-intersection") != string::npos)
-      this->add_error(201, polygonid, reason.c_str());
-    else if (reason.find("Duplicate Rings") != string::npos)
-      this->add_error(202, polygonid, reason.c_str());
-    else if (reason.find("Interior is disconnected") != string::npos)
-      this->add_error(205, polygonid, reason.c_str());
-    else if (reason.find("Hole lies outside shell") != string::npos)
-      this->add_error(206, polygonid, reason.c_str());
-    else if (reason.find("Holes are nested") != string::npos)
-      this->add_error(207, polygonid, reason.c_str());
+    std::stringstream info;
+    if (reason != NULL)
+      info << reason;
+    if (location != NULL)
+    {
+      double x, y;
+      GEOSGeomGetX_r(h, location, &x);
+      GEOSGeomGetY_r(h, location, &y);
+      info << " [" << setprecision(15) << x << " " << y << "]";
+    }
+    auto it = (reason != NULL) ? GEOS_REASONS.find(reason) : GEOS_REASONS.end();
+    if ( (re == 0) && (it != GEOS_REASONS.end()) )
+      this->add_error(it->second, polygonid, info.str());
     else
-      this->add_error(999, polygonid, reason.c_str());
+      this->add_error(999, polygonid, info.str());
   }
-  GEOSGeom_destroy( mygeom );
-  finishGEOS();
+  if (reason != NULL)
+    GEOSFree_r(h, reason);
+  if (location != NULL)
+    GEOSGeom_destroy_r(h, location);
+  GEOSGeom_destroy_r(h, mygeom);
   return isvalid;
 }
 
-bool Surface::has_face_2_consecutive_repeated_pts(const std::vector< std::vector<int> >& theface)
+bool Surface::has_face_2_consecutive_repeated_pts(int face)
 {
   bool bDuplicates = false;
-  std::vector< std::vector<int> >::const_iterator itr = theface.begin();
-  for ( ; itr != theface.end(); itr++) {
-    size_t numv = itr->size();
+  for (int j = 0; j < this->number_rings(face); j++) {
+    RingView r = this->get_ring(face, j);
+    size_t numv = r.size();
     //-- first-last not the same (they are not in GML format anymore)
-    if ((*itr)[0] == (*itr)[numv - 1]) {
+    if (r[0] == r[numv - 1]) {
       bDuplicates = true;
       break;
     }
     for (int i = 0; i < (static_cast<int>(numv) - 1); i++) {
-      if ((*itr)[i] == (*itr)[i+1]) {
+      if (r[i] == r[i+1]) {
         bDuplicates = true;
         break;
       }
@@ -902,12 +1305,13 @@ bool Surface::has_face_2_consecutive_repeated_pts(const std::vector< std::vector
   return bDuplicates;
 }
 
-bool Surface::has_face_rings_toofewpoints(const std::vector< std::vector<int> >& theface)
+
+bool Surface::has_face_rings_toofewpoints(int face)
 {
-  bool bErrors = false;
-  std::vector< std::vector<int> >::const_iterator itr = theface.begin();
-  for ( ; itr != theface.end(); itr++) {
-    if (itr->size() < 3) {
+  //-- a face without any ring is also reported
+  bool bErrors = (this->number_rings(face) == 0);
+  for (int j = 0; j < this->number_rings(face); j++) {
+    if (this->get_ring(face, j).size() < 3) {
       bErrors = true;
       break;
     }
@@ -917,17 +1321,17 @@ bool Surface::has_face_rings_toofewpoints(const std::vector< std::vector<int> >&
 
 int Surface::side_of_triangle_surface(Point3& p)
   /*
-   -2 = not valid polyhedron
+   -2 = not valid mesh
    -1 = outside
    0 = directly on the boundary of polyhedron
    1 = inside
    */
 {
   int re = -2;
-  if ( (_polyhedron != NULL) && (CGAL::is_triangle_mesh(*_polyhedron) == true) )
+  if ( (_mesh != NULL) && (CGAL::is_triangle_mesh(*_mesh) == true) )
   {
-    CGAL::Side_of_triangle_mesh<CgalPolyhedron, K> inside(*_polyhedron);
-    Point3 p_translated(p.x() - Surface::_shiftx, p.y() - Surface::_shifty, p.z());
+    CGAL::Side_of_triangle_mesh<CgalMesh, K> inside(*_mesh);
+    Point3 p_translated(p.x() - _shiftx, p.y() - _shifty, p.z());
     re = inside(p_translated);
   }
   return re;
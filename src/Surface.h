@@ -35,16 +35,45 @@
 #include <vector>
 #include <set>
 #include <unordered_map>
+#include <tuple>
 
 using json = nlohmann::json;
 
 namespace val3dity
 {
 
+class ValidationContext;
+
+//-- one ring of a face: a range in the flat vertex ids of a Surface
+struct RingView
+{
+  const int* first;
+  const int* last;
+  const int* begin() const { return first; }
+  const int* end() const   { return last; }
+  size_t     size() const  { return last - first; }
+  int        operator[](size_t i) const { return first[i]; }
+};
+
+//-- a cell of the grid used to snap the vertices
+typedef std::tuple<int64, int64, int64> GridCell;
+
+struct GridCellHash
+{
+  std::size_t operator()(const GridCell& c) const
+  {
+    std::size_t h = std::hash<int64>()(std::get<0>(c));
+    h = (h * 1000003) ^ std::hash<int64>()(std::get<1>(c));
+    h = (h * 1000003) ^ std::hash<int64>()(std::get<2>(c));
+    return h;
+  }
+};
+
 class Surface
 {
 public:
-  Surface  (int id = -1, double tol_snap = 0.0);
+  //-- snap=false for inputs whose faces refer to the vertex ids of the file (POLY/OFF)
+  Surface  (const ValidationContext& ctx, int id = -1, bool snap = true);
   ~Surface ();
   
   bool validate_as_shell(double tol_planarity_d2p, double tol_planarity_normals);
@@ -53,7 +82,7 @@ public:
   
   bool is_shell(double tol_planarity_d2p, double tol_planarity_normals);
 
-  CgalPolyhedron* get_cgal_polyhedron();
+  CgalMesh* get_cgal_mesh();
 
   int    number_vertices();
   int    number_faces();
@@ -63,14 +92,22 @@ public:
   bool   does_self_intersect();
   bool   is_empty();
   int    add_point(Point3 p);
+  //-- for inputs whose vertices are shared by index (CityJSON): a vertex
+  //-- index is snapped only the first time, then found in O(1)
+  int    add_point(Point3 p, int vertexid);
+  int    get_point_id(int vertexid);
   void   add_face(std::vector< std::vector<int> > f, std::string id = "");
+  //-- a face built in place, ring by ring: add_face() then for each ring 
+  //-- add_ring() and add_ring_vertex() for each of its vertices
+  void   add_face(std::string id = "");
+  void   add_ring();
+  void   add_ring_vertex(int id);
 
   json          get_report_json();
   void          add_error(int code, std::string faceid = "", std::string info = "");
   bool          has_errors();
   std::set<int> get_unique_error_codes();
   void          translate_vertices();
-  static void   set_translation_min_values(double minx, double miny);
   std::string   get_poly_representation();
   std::string   get_off_representation();
 
@@ -82,27 +119,54 @@ public:
 private:
   int                                     _id;
   std::vector<Point3>                     _lsPts;
-  std::vector< std::vector< std::vector<int> > >    _lsFaces;
-  std::vector<std::string>                _lsFacesID;
-  std::vector< std::vector<int*> >        _lsTr;
-  CgalPolyhedron*                         _polyhedron;
+  //-- the faces in compressed sparse rows: face f has the rings 
+  //-- [_lsFaceOffsets[f], _lsFaceOffsets[f+1]), and ring r the vertex ids
+  //-- _lsRingVertices[_lsRingOffsets[r]] to _lsRingVertices[_lsRingOffsets[r+1] - 1]
+  std::vector<int>                        _lsRingVertices;
+  std::vector<int>                        _lsRingOffsets;
+  std::vector<int>                        _lsFaceOffsets;
+  //-- from the 2D validation to the triangulation: the projection of each 
+  //-- vertex of _lsRingVertices on the plane fitted to its face
+  std::vector<Point2>                     _lsProjected;
+  //-- ids of the faces given in the input (gml:id), the others are numbered
+  std::unordered_map<int, std::string>    _dFacesID;
+  //-- the triangles of all the faces, those of face f are 
+  //-- [_lsTrOffsets[f], _lsTrOffsets[f+1])
+  std::vector<TriangleIds>                _lsTr;
+  std::vector<int>                        _lsTrOffsets;
+  CgalMesh*                               _mesh;
   double                                  _tol_snap;
+  PolygonEngine                           _polygon_engine;
+  int                                     _min_triangles_parallel;
+  bool                                    _auto_orient;
   int                                     _is_valid_2d; //-1: not done yet; 0: nope; 1: yes it's valid
   int                                     _vertices_added;
-  static double                           _shiftx;
-  static double                           _shifty;
+  double                                  _shiftx;
+  double                                  _shifty;
+  //-- only for the parsing, both are freed when the validation starts
+  //-- ids of the points in each cell (cells of size tol_snap)
+  std::unordered_map<GridCell, std::vector<int>, GridCellHash> _grid;
+  //-- vertex index in the input -> id in _lsPts
+  std::unordered_map<int, int>            _dVertexIds;
 
   std::map<int, std::vector<std::tuple<std::string, std::string> > > _errors;
   
   bool validate_2d_primitives(double tol_planarity_d2p, double tol_planarity_normals);
-  std::string get_coords_key(Point3* p);
+  GridCell    get_grid_cell(const Point3& p);
   bool triangulate_shell();
-  bool construct_ct(const std::vector< std::vector<int> >& pgnids, const std::vector<Polygon>& lsRings, std::vector<int*>& oneface, int faceNum, const CgalPolyhedron::Plane_3 &plane);
+  int         number_rings(int face) const;
+  RingView    get_ring(int face, int ring) const;
+  std::string get_face_id(int face) const;
+  void        project_face(int face, const CgalPolyhedron::Plane_3& plane);
+  Polygon     get_projected_ring(int face, int ring) const;
+  bool        is_projected_ring_convex(int face, int ring) const;
+  bool construct_ct(int face);
   bool validate_polygon(std::vector<Polygon> &lsRings, std::string polygonid);
   bool validate_projected_ring(Polygon &pgn, std::string id);
-  bool has_face_rings_toofewpoints(const std::vector< std::vector<int> >& theface);
-  bool has_face_2_consecutive_repeated_pts(const std::vector< std::vector<int> >& theface);
-  bool contains_nonmanifold_vertices();
+  bool has_face_rings_toofewpoints(int face);
+  bool has_face_2_consecutive_repeated_pts(int face);
+  bool precheck_combinatorics(bool isshell);
+  int  orient_faces();
 
 };
 
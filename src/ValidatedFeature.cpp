@@ -0,0 +1,92 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+
+#include "ValidatedFeature.h"
+#include "ValidatedPrimitive.h"
+
+namespace val3dity
+{
+
+ValidatedFeature::ValidatedFeature(Feature* f)
+{
+  _id = f->get_id();
+  _type = f->get_type();
+  _is_valid = (f->is_valid() == true) ? 1 : 0;
+  _codes = f->get_unique_error_codes();
+  //-- the report of the primitives is kept by each of them
+  _report = f->get_report_json();
+  _report.erase("primitives");
+  for (auto& p : f->get_primitives())
+    _lsPrimitives.push_back(new ValidatedPrimitive(p));
+}
+
+
+ValidatedFeature::~ValidatedFeature()
+{
+  //-- the copies of GeometryTemplates are not shared
+  for (auto& p : _lsPrimitives)
+    delete p;
+  _lsPrimitives.clear();
+}
+
+
+bool ValidatedFeature::validate(const ValidationContext& ctx) 
+{
+  return this->is_valid();
+}
+
+
+bool ValidatedFeature::is_valid() 
+{
+  return (_is_valid == 1);
+}
+
+
+std::string ValidatedFeature::get_type() 
+{
+  return _type;
+}
+
+
+json ValidatedFeature::get_report_json() 
+{
+  json j = _report;
+  j["primitives"];
+  for (auto& p : _lsPrimitives)
+    j["primitives"].push_back(p->get_report_json()); 
+  return j;
+}
+
+
+std::set<int> ValidatedFeature::get_unique_error_codes()
+{
+  return _codes;
+}
+
+} // namespace val3dity
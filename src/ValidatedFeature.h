@@ -0,0 +1,61 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+#ifndef __val3dity__ValidatedFeature__
+#define __val3dity__ValidatedFeature__
+
+#include "Feature.h"
+#include "definitions.h"
+
+
+namespace val3dity
+{
+
+//-- what is kept of a Feature once it is validated: its validity, errors
+//-- and report, but not its geometry. Used when a file is streamed, so that
+//-- the summary and the report can be made after the geometry is freed.
+class ValidatedFeature : public Feature
+{
+public:
+  ValidatedFeature(Feature* f);
+  ~ValidatedFeature();
+  
+  bool            validate(const ValidationContext& ctx);
+  bool            is_valid();
+  std::string     get_type();
+  json            get_report_json();
+  std::set<int>   get_unique_error_codes();
+
+private:
+  json            _report;
+  std::set<int>   _codes;
+};
+
+} // namespace val3dity
+
+#endif /* defined(__val3dity__ValidatedFeature__) */
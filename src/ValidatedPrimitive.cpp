@@ -0,0 +1,89 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+#include "ValidatedPrimitive.h"
+
+namespace val3dity
+{
+
+ValidatedPrimitive::ValidatedPrimitive(Primitive* p)
+{
+  _id = p->get_id();
+  _type = p->get_type();
+  _is_valid = p->is_valid();
+  _is_empty = p->is_empty();
+  p->get_min_bbox(_minx, _miny);
+  _report = p->get_report_json();
+  _codes = p->get_unique_error_codes();
+}
+
+ValidatedPrimitive::~ValidatedPrimitive() {
+}
+
+bool ValidatedPrimitive::validate(const ValidationContext& ctx) 
+{
+  return (_is_valid == 1);
+}
+
+int ValidatedPrimitive::is_valid() 
+{
+  return _is_valid;
+}
+
+bool ValidatedPrimitive::is_empty() 
+{
+  return _is_empty;
+}
+
+json ValidatedPrimitive::get_report_json() 
+{
+  return _report;
+}
+
+Primitive3D ValidatedPrimitive::get_type() 
+{
+  return _type;
+}
+
+std::set<int> ValidatedPrimitive::get_unique_error_codes() 
+{
+  return _codes;
+}
+
+void ValidatedPrimitive::get_min_bbox(double& x, double& y)
+{
+  x = _minx;
+  y = _miny;
+}
+
+void ValidatedPrimitive::translate_vertices()
+{
+  //-- the geometry is not kept
+}
+
+} // namespace val3dity
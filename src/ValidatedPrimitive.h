@@ -0,0 +1,65 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+#ifndef ValidatedPrimitive_h
+#define ValidatedPrimitive_h
+
+#include "Primitive.h"
+
+namespace val3dity
+{
+
+//-- what is kept of a Primitive once it is validated (see ValidatedFeature)
+class ValidatedPrimitive : public Primitive 
+{
+public:
+                ValidatedPrimitive(Primitive* p); 
+                ~ValidatedPrimitive(); 
+
+  bool          validate(const ValidationContext& ctx);
+  int           is_valid();
+  bool          is_empty();
+  json          get_report_json();
+  Primitive3D   get_type();
+  std::set<int> get_unique_error_codes();
+
+  void          get_min_bbox(double& x, double& y);
+  void          translate_vertices();
+
+protected:
+  Primitive3D   _type;
+  bool          _is_empty;
+  double        _minx;
+  double        _miny;
+  json          _report;
+  std::set<int> _codes;
+};
+
+} // namespace val3dity
+
+#endif /* ValidatedPrimitive_h */
@@ -0,0 +1,179 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+#include "ValidationContext.h"
+
+namespace val3dity
+{
+
+ValidationContext::ValidationContext(double tol_snap, double tol_planarity_d2p, double tol_planarity_normals, double tol_overlap)
+{
+  _tol_snap = tol_snap;
+  _tol_planarity_d2p = tol_planarity_d2p;
+  _tol_planarity_normals = tol_planarity_normals;
+  _tol_overlap = tol_overlap;
+  _polygon_engine = ENGINE_GEOS;
+  _min_triangles_parallel = 50000;
+  _auto_orient = false;
+  _minx = 9e15;
+  _miny = 9e15;
+}
+
+
+double ValidationContext::get_tol_snap() const
+{
+  return _tol_snap;
+}
+
+
+double ValidationContext::get_tol_planarity_d2p() const
+{
+  return _tol_planarity_d2p;
+}
+
+
+double ValidationContext::get_tol_planarity_normals() const
+{
+  return _tol_planarity_normals;
+}
+
+
+double ValidationContext::get_tol_overlap() const
+{
+  return _tol_overlap;
+}
+
+
+void ValidationContext::set_tol_snap(double tol)
+{
+  _tol_snap = tol;
+}
+
+
+void ValidationContext::set_tol_planarity_d2p(double tol)
+{
+  _tol_planarity_d2p = tol;
+}
+
+
+void ValidationContext::set_tol_planarity_normals(double tol)
+{
+  _tol_planarity_normals = tol;
+}
+
+
+void ValidationContext::set_tol_overlap(double tol)
+{
+  _tol_overlap = tol;
+}
+
+
+PolygonEngine ValidationContext::get_polygon_engine() const
+{
+  return _polygon_engine;
+}
+
+
+void ValidationContext::set_polygon_engine(PolygonEngine engine)
+{
+  _polygon_engine = engine;
+}
+
+
+int ValidationContext::get_min_triangles_parallel() const
+{
+  return _min_triangles_parallel;
+}
+
+
+void ValidationContext::set_min_triangles_parallel(int n)
+{
+  _min_triangles_parallel = n;
+}
+
+
+bool ValidationContext::get_auto_orient() const
+{
+  return _auto_orient;
+}
+
+
+void ValidationContext::set_auto_orient(bool b)
+{
+  _auto_orient = b;
+}
+
+
+void ValidationContext::update_translation(double x, double y)
+{
+  if (x < _minx)
+    _minx = x;
+  if (y < _miny)
+    _miny = y;
+}
+
+
+double ValidationContext::get_translation_x() const
+{
+  return _minx;
+}
+
+
+double ValidationContext::get_translation_y() const
+{
+  return _miny;
+}
+
+
+std::string ValidationContext::ns(const std::string& name) const
+{
+  auto it = _namespaces.find(name);
+  if (it == _namespaces.end())
+    return "";
+  return it->second;
+}
+
+
+bool ValidationContext::has_namespace(const std::string& name) const
+{
+  return (_namespaces.count(name) != 0);
+}
+
+
+void ValidationContext::set_namespace(const std::string& name, const std::string& prefix)
+{
+  _namespaces[name] = prefix;
+}
+
+
+IOErrors& ValidationContext::get_io_errors()
+{
+  return _ioerrors;
+}
+
+} // namespace val3dity
@@ -0,0 +1,97 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+#ifndef ValidationContext_h
+#define ValidationContext_h
+
+#include "input.h"
+
+#include <map>
+#include <string>
+
+namespace val3dity
+{
+
+//-- everything that belongs to one input document: the tolerances, the
+//-- translation of its coordinates, its XML namespaces, and its IO errors.
+//-- It is passed to the readers and the validators, thus several documents
+//-- can be read and validated in the same process.
+class ValidationContext
+{
+public:
+                ValidationContext(double tol_snap = 0.001, 
+                                  double tol_planarity_d2p = 0.01, 
+                                  double tol_planarity_normals = 20.0, 
+                                  double tol_overlap = -1);
+
+  double        get_tol_snap() const;
+  double        get_tol_planarity_d2p() const;
+  double        get_tol_planarity_normals() const;
+  double        get_tol_overlap() const;
+  void          set_tol_snap(double tol);
+  void          set_tol_planarity_d2p(double tol);
+  void          set_tol_planarity_normals(double tol);
+  void          set_tol_overlap(double tol);
+  PolygonEngine get_polygon_engine() const;
+  void          set_polygon_engine(PolygonEngine engine);
+  //-- surfaces with more triangles are tested for self-intersections in parallel
+  int           get_min_triangles_parallel() const;
+  void          set_min_triangles_parallel(int n);
+  //-- the faces of the shells are reoriented consistently before they are validated
+  bool          get_auto_orient() const;
+  void          set_auto_orient(bool b);
+
+  //-- (minx, miny) of the input, subtracted from all the coordinates
+  void          update_translation(double x, double y);
+  double        get_translation_x() const;
+  double        get_translation_y() const;
+
+  //-- prefix of a namespace (eg "gml" -> "gml:"), "" if not declared
+  std::string   ns(const std::string& name) const;
+  bool          has_namespace(const std::string& name) const;
+  void          set_namespace(const std::string& name, const std::string& prefix);
+
+  IOErrors&     get_io_errors();
+
+private:
+  double                              _tol_snap;
+  double                              _tol_planarity_d2p;
+  double                              _tol_planarity_normals;
+  double                              _tol_overlap;
+  PolygonEngine                       _polygon_engine;
+  int                                 _min_triangles_parallel;
+  bool                                _auto_orient;
+  double                              _minx;
+  double                              _miny;
+  std::map<std::string, std::string>  _namespaces;
+  IOErrors                            _ioerrors;
+};
+
+} // namespace val3dity
+
+#endif /* ValidationContext_h */
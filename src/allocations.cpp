@@ -0,0 +1,70 @@
+/*
+  val3dity
+
+  Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of the Built Environment & Architecture
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+#include "allocations.h"
+#include <cstdlib>
+#include <new>
+
+#ifndef NDEBUG
+//-- per thread, no allocation is needed to access it
+static thread_local size_t nallocations = 0;
+
+//-- the global operator new counts, new[] and the deletes use it
+void* operator new(std::size_t size)
+{
+  nallocations++;
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == NULL)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+#endif
+
+namespace val3dity
+{
+
+size_t get_number_allocations()
+{
+#ifndef NDEBUG
+  return nallocations;
+#else
+  return 0;
+#endif
+}
+
+} // namespace val3dity
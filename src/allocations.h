@@ -0,0 +1,45 @@
+/*
+  val3dity
+
+  Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of the Built Environment & Architecture
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+
+#ifndef __val3dity__allocations__
+#define __val3dity__allocations__
+
+#include <cstddef>
+
+namespace val3dity
+{
+
+//-- number of heap allocations made so far by the calling thread (in batch
+//-- mode the reading runs in parallel with the validation). They are only 
+//-- counted in debug builds (NDEBUG not defined), it is always 0 otherwise.
+size_t get_number_allocations();
+
+} // namespace val3dity
+
+#endif /* defined(__val3dity__allocations__) */
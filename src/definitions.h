@@ -33,6 +33,7 @@
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Exact_predicates_exact_constructions_kernel.h>
 #include <CGAL/Polyhedron_3.h>
+#include <CGAL/Surface_mesh.h>
 #include <CGAL/basic.h>
 #include <CGAL/Triangulation_vertex_base_with_id_2.h>
 #include <CGAL/Triangulation_face_base_with_info_2.h>
@@ -41,11 +42,11 @@
 #include <CGAL/Nef_polyhedron_3.h>
 #include <CGAL/IO/Polyhedron_iostream.h>
 #include <CGAL/IO/Nef_polyhedron_iostream_3.h>
-#include <CGAL/Polyhedron_copy_3.h>
 
 #include <CGAL/Aff_transformation_3.h>
 
 #include <string>
+#include <array>
 
 namespace val3dity
 {
@@ -70,6 +71,8 @@ typedef K::Tetrahedron_3            Tetrahedron;
 typedef K::Plane_3                  Plane;
 typedef CGAL::Polygon_2<K>          Polygon;
 typedef CGAL::Polyhedron_3<K>       CgalPolyhedron;
+//-- the shells: index-based, the connectivity and the points in flat arrays
+typedef CGAL::Surface_mesh<Point3>  CgalMesh;
 
 
 // CGAL typedefs
@@ -89,10 +92,11 @@ typedef CGAL::Polyhedron_3<KE>                              CgalPolyhedronE;
 typedef CGAL::Nef_polyhedron_3<KE>                          Nef_polyhedron;
 typedef CGAL::Aff_transformation_3<KE>                      Transformation;
 
-typedef CGAL::Polyhedron_copy_3<CgalPolyhedron, CgalPolyhedronE::HalfedgeDS> Polyhedron_convert; 
-
 typedef long long int64;
 
+//-- the ids of the 3 vertices of a triangle
+typedef std::array<int, 3> TriangleIds;
+
 typedef enum
 {
   SOLID             = 0,
@@ -112,8 +116,16 @@ typedef enum
   POLY  = 3,
   OFF   = 4,
   OTHER = 5,
+  JSONL = 6,
 } InputTypes;
 
+//-- how the projected polygons are validated (201, 202, 205-207)
+typedef enum
+{
+  ENGINE_GEOS   = 0,
+  ENGINE_NATIVE = 1,
+} PolygonEngine;
+
 
 struct Error {
   int         errorcode;
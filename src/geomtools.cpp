@@ -30,8 +30,10 @@
 #include "CGAL/squared_distance_3.h"
 #include <CGAL/linear_least_squares_fitting_3.h>
 #include <CGAL/minkowski_sum_3.h>
-#include <CGAL/OFF_to_nef_3.h>
+#include <CGAL/Polygon_mesh_processing/polygon_soup_to_polygon_mesh.h>
 #include <CGAL/Bbox_3.h>
+#include <algorithm>
+#include <cmath>
 
 namespace val3dity
 {
@@ -85,69 +87,55 @@ void mark_domains(CT& ct) {
   }
 }  
 
+//-- a closed polyhedron (faces oriented outwards) built directly from its 
+//-- points and its faces, without going through an OFF stream
+static Nef_polyhedron* build_nef_polyhedron(const std::vector<Point3E>& lsPts, const std::vector<std::vector<std::size_t>>& lsFaces)
+{
+  CgalPolyhedronE p;
+  CGAL::Polygon_mesh_processing::polygon_soup_to_polygon_mesh(lsPts, lsFaces, p);
+  return new Nef_polyhedron(p);
+}
+
+
 Nef_polyhedron* get_structuring_element_dodecahedron(float r)
 {
-  std::stringstream ss;
-  ss << "OFF" << std::endl
-    << "20 36 0"      << std::endl
-    << "-0.57735 -0.57735 0.57735" << std::endl
-    << "0.934172 0.356822 0" << std::endl
-    << "0.934172 -0.356822 0" << std::endl
-    << "-0.934172 0.356822 0" << std::endl
-    << "-0.934172 -0.356822 0" << std::endl
-    << "0 0.934172 0.356822" << std::endl
-    << "0 0.934172 -0.356822" << std::endl
-    << "0.356822 0 -0.934172" << std::endl
-    << "-0.356822 0 -0.934172" << std::endl
-    << "0 -0.934172 -0.356822" << std::endl
-    << "0 -0.934172 0.356822" << std::endl
-    << "0.356822 0 0.934172" << std::endl
-    << "-0.356822 0 0.934172" << std::endl
-    << "0.57735 0.57735 -0.57735" << std::endl
-    << "0.57735 0.57735 0.57735" << std::endl
-    << "-0.57735 0.57735 -0.57735" << std::endl
-    << "-0.57735 0.57735 0.57735" << std::endl
-    << "0.57735 -0.57735 -0.57735" << std::endl
-    << "0.57735 -0.57735 0.57735" << std::endl
-    << "-0.57735 -0.57735 -0.57735" << std::endl
-    << "3 18 2 1" << std::endl
-    << "3 11 18 1" << std::endl
-    << "3 14 11 1" << std::endl
-    << "3 7 13 1" << std::endl
-    << "3 17 7 1" << std::endl
-    << "3 2 17 1" << std::endl
-    << "3 19 4 3" << std::endl
-    << "3 8 19 3" << std::endl
-    << "3 15 8 3" << std::endl
-    << "3 12 16 3" << std::endl
-    << "3 0 12 3" << std::endl
-    << "3 4 0 3" << std::endl
-    << "3 6 15 3" << std::endl
-    << "3 5 6 3" << std::endl
-    << "3 16 5 3" << std::endl
-    << "3 5 14 1" << std::endl
-    << "3 6 5 1" << std::endl
-    << "3 13 6 1" << std::endl
-    << "3 9 17 2" << std::endl
-    << "3 10 9 2" << std::endl
-    << "3 18 10 2" << std::endl
-    << "3 10 0 4" << std::endl
-    << "3 9 10 4" << std::endl
-    << "3 19 9 4" << std::endl
-    << "3 19 8 7" << std::endl
-    << "3 9 19 7" << std::endl
-    << "3 17 9 7" << std::endl
-    << "3 8 15 6" << std::endl
-    << "3 7 8 6" << std::endl
-    << "3 13 7 6" << std::endl
-    << "3 11 14 5" << std::endl
-    << "3 12 11 5" << std::endl
-    << "3 16 12 5" << std::endl
-    << "3 12 0 10" << std::endl
-    << "3 11 12 10" << std::endl
-    << "3 18 11 10" << std::endl;
-  Nef_polyhedron* myse = new Nef_polyhedron;
-  CGAL::OFF_to_nef_3(ss, *myse);
+  std::vector<Point3E> lsPts = {
+    Point3E(-0.57735, -0.57735, 0.57735),
+    Point3E(0.934172, 0.356822, 0),
+    Point3E(0.934172, -0.356822, 0),
+    Point3E(-0.934172, 0.356822, 0),
+    Point3E(-0.934172, -0.356822, 0),
+    Point3E(0, 0.934172, 0.356822),
+    Point3E(0, 0.934172, -0.356822),
+    Point3E(0.356822, 0, -0.934172),
+    Point3E(-0.356822, 0, -0.934172),
+    Point3E(0, -0.934172, -0.356822),
+    Point3E(0, -0.934172, 0.356822),
+    Point3E(0.356822, 0, 0.934172),
+    Point3E(-0.356822, 0, 0.934172),
+    Point3E(0.57735, 0.57735, -0.57735),
+    Point3E(0.57735, 0.57735, 0.57735),
+    Point3E(-0.57735, 0.57735, -0.57735),
+    Point3E(-0.57735, 0.57735, 0.57735),
+    Point3E(0.57735, -0.57735, -0.57735),
+    Point3E(0.57735, -0.57735, 0.57735),
+    Point3E(-0.57735, -0.57735, -0.57735)
+  };
+  std::vector<std::vector<std::size_t>> lsFaces = {
+    {18, 2, 1}, {11, 18, 1}, {14, 11, 1},
+    {7, 13, 1}, {17, 7, 1}, {2, 17, 1},
+    {19, 4, 3}, {8, 19, 3}, {15, 8, 3},
+    {12, 16, 3}, {0, 12, 3}, {4, 0, 3},
+    {6, 15, 3}, {5, 6, 3}, {16, 5, 3},
+    {5, 14, 1}, {6, 5, 1}, {13, 6, 1},
+    {9, 17, 2}, {10, 9, 2}, {18, 10, 2},
+    {10, 0, 4}, {9, 10, 4}, {19, 9, 4},
+    {19, 8, 7}, {9, 19, 7}, {17, 9, 7},
+    {8, 15, 6}, {7, 8, 6}, {13, 7, 6},
+    {11, 14, 5}, {12, 11, 5}, {16, 12, 5},
+    {12, 0, 10}, {11, 12, 10}, {18, 11, 10}
+  };
+  Nef_polyhedron* myse = build_nef_polyhedron(lsPts, lsFaces);
   Transformation scale(CGAL::SCALING, r);
   myse->transform(scale);
   return myse;
@@ -155,25 +143,14 @@ Nef_polyhedron* get_structuring_element_dodecahedron(float r)
 
 Nef_polyhedron* get_structuring_element_cube(float r)
 {
-  std::stringstream ss;
-  ss << "OFF"        << std::endl
-     << "8 6 0"      << std::endl
-     << "1 1 1"      << std::endl
-     << "-1 1 1"     << std::endl
-     << "1 -1 1"     << std::endl
-     << "-1 -1 1"    << std::endl
-     << "1 1 -1 "    << std::endl
-     << "-1 1 -1"    << std::endl
-     << "1 -1 -1"    << std::endl
-     << "-1 -1 -1"   << std::endl
-     << "4 1 3 2 0"  << std::endl
-     << "4 2 6 4 0"  << std::endl
-     << "4 4 5 1 0"  << std::endl
-     << "4 5 4 6 7"  << std::endl
-     << "4 6 2 3 7"  << std::endl
-     << "4 3 1 5 7"  << std::endl;
-  Nef_polyhedron* mycube = new Nef_polyhedron;
-  CGAL::OFF_to_nef_3(ss, *mycube);
+  std::vector<Point3E> lsPts = {
+    Point3E( 1,  1,  1), Point3E(-1,  1,  1), Point3E( 1, -1,  1), Point3E(-1, -1,  1),
+    Point3E( 1,  1, -1), Point3E(-1,  1, -1), Point3E( 1, -1, -1), Point3E(-1, -1, -1)
+  };
+  std::vector<std::vector<std::size_t>> lsFaces = {
+    {1, 3, 2, 0}, {2, 6, 4, 0}, {4, 5, 1, 0}, {5, 4, 6, 7}, {6, 2, 3, 7}, {3, 1, 5, 7}
+  };
+  Nef_polyhedron* mycube = build_nef_polyhedron(lsPts, lsFaces);
   Transformation scale(CGAL::SCALING, r);
   mycube->transform(scale);
   return mycube;
@@ -238,34 +215,21 @@ Nef_polyhedron* get_aabb(Nef_polyhedron* mynef)
   xmax += 10;
   ymax += 10;
   zmax += 10;
-  //-- write an OFF file and convert Nef, simplest (and fastest?) solution
-  std::stringstream ss;
-  ss << "OFF" << std::endl
-     << "8 6 0" << std::endl
-     << xmin << " " << ymin << " " << zmin << std::endl
-     << xmax << " " << ymin << " " << zmin << std::endl
-     << xmax << " " << ymax << " " << zmin << std::endl
-     << xmin << " " << ymax << " " << zmin << std::endl
-     << xmin << " " << ymin << " " << zmax << std::endl
-     << xmax << " " << ymin << " " << zmax << std::endl
-     << xmax << " " << ymax << " " << zmax << std::endl
-     << xmin << " " << ymax << " " << zmax << std::endl
-     << "4 0 3 2 1" << std::endl
-     << "4 0 1 5 4"    << std::endl
-     << "4 1 2 6 5"    << std::endl
-     << "4 2 3 7 6"    << std::endl
-     << "4 0 4 7 3"    << std::endl
-     << "4 4 5 6 7"    << std::endl;
-  Nef_polyhedron* nefbbox = new Nef_polyhedron;
-  CGAL::OFF_to_nef_3(ss, *nefbbox);
+  std::vector<Point3E> lsPts = {
+    Point3E(xmin, ymin, zmin), Point3E(xmax, ymin, zmin), Point3E(xmax, ymax, zmin), Point3E(xmin, ymax, zmin),
+    Point3E(xmin, ymin, zmax), Point3E(xmax, ymin, zmax), Point3E(xmax, ymax, zmax), Point3E(xmin, ymax, zmax)
+  };
+  std::vector<std::vector<std::size_t>> lsFaces = {
+    {0, 3, 2, 1}, {0, 1, 5, 4}, {1, 2, 6, 5}, {2, 3, 7, 6}, {0, 4, 7, 3}, {4, 5, 6, 7}
+  };
+  Nef_polyhedron* nefbbox = build_nef_polyhedron(lsPts, lsFaces);
   return nefbbox;
 }
 
 
-CgalPolyhedron::Plane_3  get_best_fitted_plane(const std::vector< Point3 > &lsPts)
+//-- the components of the normal smaller than 1e-12 are snapped to 0
+static CgalPolyhedron::Plane_3 clamp_plane(const CgalPolyhedron::Plane_3& p)
 {
-  CgalPolyhedron::Plane_3 p;
-  linear_least_squares_fitting_3(lsPts.begin(), lsPts.end(), p, CGAL::Dimension_tag<0>());  
   K::FT tol = 1e-12;
   K::FT a = p.a();
   K::FT b = p.b();
@@ -291,6 +255,123 @@ CgalPolyhedron::Plane_3  get_best_fitted_plane(const std::vector< Point3 > &lsPt
 }
 
 
+CgalPolyhedron::Plane_3  get_best_fitted_plane_cgal(const std::vector< Point3 > &lsPts)
+{
+  CgalPolyhedron::Plane_3 p;
+  linear_least_squares_fitting_3(lsPts.begin(), lsPts.end(), p, CGAL::Dimension_tag<0>());  
+  return clamp_plane(p);
+}
+
+
+//-- same plane as linear_least_squares_fitting_3() (through the centroid, 
+//-- normal is the eigenvector of the smallest eigenvalue of the covariance) 
+//-- but the 3x3 eigenproblem is solved in closed form. CGAL is used when the 
+//-- smallest eigenvalue is not well separated (eg points almost collinear)
+CgalPolyhedron::Plane_3  get_best_fitted_plane(const std::vector< Point3 > &lsPts)
+{
+  size_t n = lsPts.size();
+  if (n < 3)
+    return get_best_fitted_plane_cgal(lsPts);
+  //-- 1. axis-aligned faces (flat roofs, floors, walls of boxes): nothing to solve
+  double x0 = CGAL::to_double(lsPts[0].x());
+  double y0 = CGAL::to_double(lsPts[0].y());
+  double z0 = CGAL::to_double(lsPts[0].z());
+  bool samex = true;
+  bool samey = true;
+  bool samez = true;
+  //-- 2. covariance accumulated in one pass, relative to the 1st point
+  double sx = 0.0, sy = 0.0, sz = 0.0;
+  double sxx = 0.0, syy = 0.0, szz = 0.0, sxy = 0.0, sxz = 0.0, syz = 0.0;
+  for (auto& p : lsPts)
+  {
+    double dx = CGAL::to_double(p.x()) - x0;
+    double dy = CGAL::to_double(p.y()) - y0;
+    double dz = CGAL::to_double(p.z()) - z0;
+    samex &= (dx == 0.0);
+    samey &= (dy == 0.0);
+    samez &= (dz == 0.0);
+    sx += dx;
+    sy += dy;
+    sz += dz;
+    sxx += dx * dx;
+    syy += dy * dy;
+    szz += dz * dz;
+    sxy += dx * dy;
+    sxz += dx * dz;
+    syz += dy * dz;
+  }
+  if ( (samez == true) && (samex == false) && (samey == false) )
+    return CgalPolyhedron::Plane_3(0, 0, 1, -z0);
+  if ( (samex == true) && (samey == false) && (samez == false) )
+    return CgalPolyhedron::Plane_3(1, 0, 0, -x0);
+  if ( (samey == true) && (samex == false) && (samez == false) )
+    return CgalPolyhedron::Plane_3(0, 1, 0, -y0);
+  double mx = sx / n;
+  double my = sy / n;
+  double mz = sz / n;
+  double a00 = (sxx / n) - (mx * mx);
+  double a11 = (syy / n) - (my * my);
+  double a22 = (szz / n) - (mz * mz);
+  double a01 = (sxy / n) - (mx * my);
+  double a02 = (sxz / n) - (mx * mz);
+  double a12 = (syz / n) - (my * mz);
+  //-- 3. eigenvalues of a symmetric 3x3 matrix (trigonometric solution)
+  double q = (a00 + a11 + a22) / 3.0;
+  double p1 = (a01 * a01) + (a02 * a02) + (a12 * a12);
+  double p2 = ((a00 - q) * (a00 - q)) + ((a11 - q) * (a11 - q)) + ((a22 - q) * (a22 - q)) + (2.0 * p1);
+  double p = std::sqrt(p2 / 6.0);
+  if (p == 0.0)
+    return get_best_fitted_plane_cgal(lsPts);
+  double b00 = (a00 - q) / p;
+  double b11 = (a11 - q) / p;
+  double b22 = (a22 - q) / p;
+  double b01 = a01 / p;
+  double b02 = a02 / p;
+  double b12 = a12 / p;
+  double r = ( (b00 * ((b11 * b22) - (b12 * b12))) - 
+               (b01 * ((b01 * b22) - (b12 * b02))) + 
+               (b02 * ((b01 * b12) - (b11 * b02))) ) / 2.0;
+  r = std::max(-1.0, std::min(1.0, r));
+  double phi = std::acos(r) / 3.0;
+  double twothirdpi = 2.0 * std::acos(-1.0) / 3.0;
+  double eig1 = q + (2.0 * p * std::cos(phi));
+  double eig3 = q + (2.0 * p * std::cos(phi + twothirdpi));
+  double eig2 = (3.0 * q) - eig1 - eig3;
+  if ( (eig2 - eig3) <= (1e-9 * eig1) )
+    return get_best_fitted_plane_cgal(lsPts);
+  //-- 4. eigenvector of eig3: the largest cross product of 2 rows of (A - eig3.I)
+  double r0[3] = {a00 - eig3, a01, a02};
+  double r1[3] = {a01, a11 - eig3, a12};
+  double r2[3] = {a02, a12, a22 - eig3};
+  double c01[3] = {(r0[1] * r1[2]) - (r0[2] * r1[1]), (r0[2] * r1[0]) - (r0[0] * r1[2]), (r0[0] * r1[1]) - (r0[1] * r1[0])};
+  double c02[3] = {(r0[1] * r2[2]) - (r0[2] * r2[1]), (r0[2] * r2[0]) - (r0[0] * r2[2]), (r0[0] * r2[1]) - (r0[1] * r2[0])};
+  double c12[3] = {(r1[1] * r2[2]) - (r1[2] * r2[1]), (r1[2] * r2[0]) - (r1[0] * r2[2]), (r1[0] * r2[1]) - (r1[1] * r2[0])};
+  double d01 = (c01[0] * c01[0]) + (c01[1] * c01[1]) + (c01[2] * c01[2]);
+  double d02 = (c02[0] * c02[0]) + (c02[1] * c02[1]) + (c02[2] * c02[2]);
+  double d12 = (c12[0] * c12[0]) + (c12[1] * c12[1]) + (c12[2] * c12[2]);
+  double* v = c01;
+  double dmax = d01;
+  if (d02 > dmax) {
+    v = c02;
+    dmax = d02;
+  }
+  if (d12 > dmax) {
+    v = c12;
+    dmax = d12;
+  }
+  if (dmax == 0.0)
+    return get_best_fitted_plane_cgal(lsPts);
+  double l = std::sqrt(dmax);
+  double a = v[0] / l;
+  double b = v[1] / l;
+  double c = v[2] / l;
+  double cx = x0 + mx;
+  double cy = y0 + my;
+  double cz = z0 + mz;
+  return clamp_plane(CgalPolyhedron::Plane_3(a, b, c, -((a * cx) + (b * cy) + (c * cz))));
+}
+
+
 bool is_face_planar_distance2plane(const std::vector<Point3> &pts, const CgalPolyhedron::Plane_3 &plane, double& value, float tolerance)
 {
   if (pts.size() == 3) {
@@ -313,6 +394,89 @@ bool is_face_planar_distance2plane(const std::vector<Point3> &pts, const CgalPol
 }
 
 
+//-- the vertices of face f are those of its rings, which are contiguous: 
+//-- ids[ringoffsets[faceoffsets[f]]..ringoffsets[faceoffsets[f+1]]). Faces 
+//-- with a degenerate plane (eg not fitted) are skipped
+void flag_faces_distance2plane(const std::vector<Point3>& lsPts, const std::vector<int>& ids, const std::vector<int>& ringoffsets, const std::vector<int>& faceoffsets, const std::vector<CgalPolyhedron::Plane_3>& planes, float tolerance, std::vector<char>& flags)
+{
+  //-- a margin so that the rounding differences with CGAL don't matter
+  double tol2 = double(tolerance) * double(tolerance) * (1.0 - 1e-6);
+  size_t nf = faceoffsets.size() - 1;
+  flags.assign(nf, 0);
+  for (size_t f = 0; f < nf; f++)
+  {
+    double a = CGAL::to_double(planes[f].a());
+    double b = CGAL::to_double(planes[f].b());
+    double c = CGAL::to_double(planes[f].c());
+    double d = CGAL::to_double(planes[f].d());
+    double n2 = (a * a) + (b * b) + (c * c);
+    if (n2 == 0.0)
+      continue;
+    double maxd2 = 0.0;
+    for (int k = ringoffsets[faceoffsets[f]]; k < ringoffsets[faceoffsets[f + 1]]; k++)
+    {
+      const Point3& p = lsPts[ids[k]];
+      double e = (a * p.x()) + (b * p.y()) + (c * p.z()) + d;
+      maxd2 = std::max(maxd2, e * e);
+    }
+    //-- written so that a NaN is flagged
+    flags[f] = !(maxd2 < (tol2 * n2));
+  }
+}
+
+
+//-- the unit normal of a triangle, NaN if it is degenerate
+static void get_unit_normal(const std::vector<Point3>& lsPts, const TriangleIds& tr, double n[3])
+{
+  const Point3& p0 = lsPts[tr[0]];
+  const Point3& p1 = lsPts[tr[1]];
+  const Point3& p2 = lsPts[tr[2]];
+  double ux = p1.x() - p0.x();
+  double uy = p1.y() - p0.y();
+  double uz = p1.z() - p0.z();
+  double vx = p2.x() - p0.x();
+  double vy = p2.y() - p0.y();
+  double vz = p2.z() - p0.z();
+  n[0] = (uy * vz) - (uz * vy);
+  n[1] = (uz * vx) - (ux * vz);
+  n[2] = (ux * vy) - (uy * vx);
+  double l = std::sqrt((n[0] * n[0]) + (n[1] * n[1]) + (n[2] * n[2]));
+  n[0] /= l;
+  n[1] /= l;
+  n[2] /= l;
+}
+
+
+//-- the triangles of face i are lsTr[lsTrOffsets[i]..lsTrOffsets[i+1]), 
+//-- they are compared with its first one (like is_face_planar_normals())
+void flag_faces_normals(const std::vector<Point3>& lsPts, const std::vector<TriangleIds>& lsTr, const std::vector<int>& lsTrOffsets, float angleTolerance, std::vector<char>& flags)
+{
+  //-- angle > tolerance <=> dot < cos(tolerance), with a margin for rounding
+  double mindot = std::cos(angleTolerance * PI / 180.0) + 1e-9;
+  size_t nf = lsTrOffsets.size() - 1;
+  flags.assign(nf, 0);
+  for (size_t f = 0; f < nf; f++)
+  {
+    int first = lsTrOffsets[f];
+    if (first == lsTrOffsets[f + 1])
+      continue;
+    double n0[3];
+    get_unit_normal(lsPts, lsTr[first], n0);
+    for (int t = first + 1; t < lsTrOffsets[f + 1]; t++)
+    {
+      double n[3];
+      get_unit_normal(lsPts, lsTr[t], n);
+      //-- written so that a NaN is flagged
+      if (!( ((n0[0] * n[0]) + (n0[1] * n[1]) + (n0[2] * n[2])) > mindot ))
+      {
+        flags[f] = 1;
+        break;
+      }
+    }
+  }
+}
+
+
 bool cmpPoint3(Point3 &p1, Point3 &p2, double tol)
 {
   if ( (p1 == p2) || (CGAL::squared_distance(p1, p2) <= (tol * tol)) )
@@ -322,11 +486,9 @@ bool cmpPoint3(Point3 &p1, Point3 &p2, double tol)
 }
 
 
-void create_cgal_polygon(const std::vector<Point3>& lsPts, const std::vector<int>& ids, const CgalPolyhedron::Plane_3 &plane, Polygon &outpgn)
+void create_cgal_polygon(const std::vector<Point3>& lsPts, const int* first, const int* last, const CgalPolyhedron::Plane_3 &plane, Polygon &outpgn)
 {
-  // int proj = projection_plane(lsPts, ids);
-  std::vector<int>::const_iterator it = ids.begin();
-  for ( ; it != ids.end(); it++)
+  for (const int* it = first; it != last; it++)
   {
     Point3 p = lsPts[*it];
     outpgn.push_back(plane.to_2d(p));
@@ -334,17 +496,18 @@ void create_cgal_polygon(const std::vector<Point3>& lsPts, const std::vector<int
 }
 
 
-bool is_face_planar_normals(const std::vector<int*> &trs, const std::vector<Point3>& lsPts, double& value, float angleTolerance)
+bool is_face_planar_normals(const TriangleIds* first, const TriangleIds* last, const std::vector<Point3>& lsPts, double& value, float angleTolerance)
 {
-  std::vector<int*>::const_iterator ittr = trs.begin();
-  int* a = *ittr;
-  Vector v0 = unit_normal( lsPts[a[0]], lsPts[a[1]], lsPts[a[2]]);
+  if (first == last)
+    return true;
+  const TriangleIds* ittr = first;
+  Vector v0 = unit_normal( lsPts[(*ittr)[0]], lsPts[(*ittr)[1]], lsPts[(*ittr)[2]]);
   ittr++;
   bool isPlanar = true;
-  for ( ; ittr != trs.end(); ittr++)
+  for ( ; ittr != last; ittr++)
   {
-    a = *ittr;
-    Vector v1 = unit_normal( lsPts[a[0]], lsPts[a[1]], lsPts[a[2]] );
+    const TriangleIds& t = *ittr;
+    Vector v1 = unit_normal( lsPts[t[0]], lsPts[t[1]], lsPts[t[2]] );
     Vector a = CGAL::cross_product(v0, v1);
     K::FT norm = sqrt(a.squared_length());
     double dot = CGAL::to_double((v0*v1));
@@ -38,11 +38,18 @@ namespace val3dity
 #define PI 3.14159265
 
 CgalPolyhedron::Plane_3  get_best_fitted_plane(const std::vector< Point3 > &lsPts);
+CgalPolyhedron::Plane_3  get_best_fitted_plane_cgal(const std::vector< Point3 > &lsPts);
 
 bool    cmpPoint3(Point3 &p1, Point3 &p2, double tol);
-void    create_cgal_polygon(const std::vector<Point3>& lsPts, const std::vector<int>& ids, const CgalPolyhedron::Plane_3 &plane, Polygon &outpgn);
+void    create_cgal_polygon(const std::vector<Point3>& lsPts, const int* first, const int* last, const CgalPolyhedron::Plane_3 &plane, Polygon &outpgn);
 bool    is_face_planar_distance2plane(const std::vector<Point3> &pts, const CgalPolyhedron::Plane_3 &plane, double& value, float tolerance);
-bool    is_face_planar_normals(const std::vector<int*> &trs, const std::vector<Point3>& lsPts, double& value, float angleTolerance);
+bool    is_face_planar_normals(const TriangleIds* first, const TriangleIds* last, const std::vector<Point3>& lsPts, double& value, float angleTolerance);
+//-- scalar pre-filters for all the faces of a surface, with doubles and
+//-- without allocations: a face is flagged if it is not planar or close to
+//-- the tolerance, it must then be tested with the functions above (which 
+//-- also give the value reported)
+void    flag_faces_distance2plane(const std::vector<Point3>& lsPts, const std::vector<int>& ids, const std::vector<int>& ringoffsets, const std::vector<int>& faceoffsets, const std::vector<CgalPolyhedron::Plane_3>& planes, float tolerance, std::vector<char>& flags);
+void    flag_faces_normals(const std::vector<Point3>& lsPts, const std::vector<TriangleIds>& lsTr, const std::vector<int>& lsTrOffsets, float angleTolerance, std::vector<char>& flags);
 
 void mark_domains(CT& ct);
 void mark_domains(CT& ct, CT::Face_handle start, int index, std::list<CT::Edge>& border);
@@ -40,6 +40,7 @@
 #include "CompositeSolid.h"
 #include "MultiSolid.h"
 #include "GeometryTemplate.h"
+#include "ValidationContext.h"
 
 
 using namespace std;
@@ -48,12 +49,6 @@ using json = nlohmann::json;
 namespace val3dity
 {
 
-double _minx = 9e15;
-double _miny = 9e15;  
-
-//-- XML namespaces map
-std::map<std::string, std::string> NS; 
-
 bool IOErrors::has_errors()
 {
   if (_errors.size() == 0)
@@ -146,8 +141,8 @@ std::string remove_xml_namespace(const char* input)
 }
 
 
-vector<int> process_gml_ring(const pugi::xml_node& n, Surface* sh, IOErrors& errs) {
-  std::string s = "./" + NS["gml"] + "LinearRing" + "/" + NS["gml"] + "pos";
+vector<int> process_gml_ring(const pugi::xml_node& n, Surface* sh, ValidationContext& ctx) {
+  std::string s = "./" + ctx.ns("gml") + "LinearRing" + "/" + ctx.ns("gml") + "pos";
   pugi::xpath_node_set npos = n.select_nodes(s.c_str());
   std::vector<int> r;
   if (npos.size() > 0) //-- <gml:pos> used
@@ -159,16 +154,16 @@ vector<int> process_gml_ring(const pugi::xml_node& n, Surface* sh, IOErrors& err
       while (ss >> buf)
         tokens.push_back(buf);
       long double x = std::stold(tokens[0]);
-      x -= _minx;
+      x -= ctx.get_translation_x();
       long double y = std::stold(tokens[1]);
-      y -= _miny;
+      y -= ctx.get_translation_y();
       Point3 p(double(x), double(y), std::stod(tokens[2]));
       r.push_back(sh->add_point(p));
     }
   }
   else //-- <gml:posList> used
   {
-    std::string s = "./" + NS["gml"] + "LinearRing" + "/" + NS["gml"] + "posList";
+    std::string s = "./" + ctx.ns("gml") + "LinearRing" + "/" + ctx.ns("gml") + "posList";
     pugi::xpath_node pl = n.select_node(s.c_str());
     if (pl == NULL)
     {
@@ -181,15 +176,15 @@ vector<int> process_gml_ring(const pugi::xml_node& n, Surface* sh, IOErrors& err
       coords.push_back(buf);
     if (coords.size() % 3 != 0)
     {
-      errs.add_error(901, "Error: <gml:posList> has bad coordinates.");
+      ctx.get_io_errors().add_error(901, "Error: <gml:posList> has bad coordinates.");
       return r;
     }
     for (int i = 0; i < coords.size(); i += 3)
     {
       long double x = std::stold(coords[i]);
-      x -= _minx;
+      x -= ctx.get_translation_x();
       long double y = std::stold(coords[i+1]);
-      y -= _miny;
+      y -= ctx.get_translation_y();
       Point3 p(double(x), double(y), std::stod(coords[i+2]));
       r.push_back(sh->add_point(p));
     }
@@ -198,11 +193,11 @@ vector<int> process_gml_ring(const pugi::xml_node& n, Surface* sh, IOErrors& err
 }
 
 
-Surface* process_gml_surface(const pugi::xml_node& n, int id, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs) 
+Surface* process_gml_surface(const pugi::xml_node& n, int id, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx) 
 {
-  std::string s = ".//" + NS["gml"] + "surfaceMember";
+  std::string s = ".//" + ctx.ns("gml") + "surfaceMember";
   pugi::xpath_node_set nsm = n.select_nodes(s.c_str());
-  Surface* sh = new Surface(id, tol_snap);
+  Surface* sh = new Surface(ctx, id);
   int i = 0;
   for (pugi::xpath_node_set::const_iterator it = nsm.begin(); it != nsm.end(); ++it)
   {
@@ -275,9 +270,9 @@ Surface* process_gml_surface(const pugi::xml_node& n, int id, std::map<std::stri
     if (std::strncmp(p.node().attribute("orientation").value(), "-", 1) == 0)
       fliporientation = true;
     //-- exterior ring (only 1)
-    s = ".//" + NS["gml"] + "exterior";
+    s = ".//" + ctx.ns("gml") + "exterior";
     pugi::xpath_node ring = p.node().select_node(s.c_str());
-    std::vector<int> r = process_gml_ring(ring.node(), sh, errs);
+    std::vector<int> r = process_gml_ring(ring.node(), sh, ctx);
     if (fliporientation == true) 
       std::reverse(r.begin(), r.end());
     if (r.front() != r.back())
@@ -291,10 +286,10 @@ Surface* process_gml_surface(const pugi::xml_node& n, int id, std::map<std::stri
       r.pop_back(); 
     oneface.push_back(r);
     //-- interior rings
-    s = ".//" + NS["gml"] + "interior";
+    s = ".//" + ctx.ns("gml") + "interior";
     pugi::xpath_node_set nint = p.node().select_nodes(s.c_str());
     for (pugi::xpath_node_set::const_iterator it = nint.begin(); it != nint.end(); ++it) {
-      std::vector<int> r = process_gml_ring(it->node(), sh, errs);
+      std::vector<int> r = process_gml_ring(it->node(), sh, ctx);
       if (fliporientation == true) 
         std::reverse(r.begin(), r.end());
       if (r.front() != r.back())
@@ -315,38 +310,38 @@ Surface* process_gml_surface(const pugi::xml_node& n, int id, std::map<std::stri
 }
 
 
-Solid* process_gml_solid(const pugi::xml_node& nsolid, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs)
+Solid* process_gml_solid(const pugi::xml_node& nsolid, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx)
 {
   //-- exterior shell
   Solid* sol = new Solid;
   if (nsolid.attribute("gml:id") != 0)
     sol->set_id(std::string(nsolid.attribute("gml:id").value()));
-  std::string s = "./" + NS["gml"] + "exterior";
+  std::string s = "./" + ctx.ns("gml") + "exterior";
   pugi::xpath_node next = nsolid.select_node(s.c_str());
-  sol->set_oshell(process_gml_surface(next.node(), 0, dallpoly, tol_snap, errs));
+  sol->set_oshell(process_gml_surface(next.node(), 0, dallpoly, ctx));
   //-- interior shells
-  s = "./" + NS["gml"] + "interior";
+  s = "./" + ctx.ns("gml") + "interior";
   pugi::xpath_node_set nint = nsolid.select_nodes(s.c_str());
   int id = 1;
   for (pugi::xpath_node_set::const_iterator it = nint.begin(); it != nint.end(); ++it)
   {
-    sol->add_ishell(process_gml_surface(it->node(), id, dallpoly, tol_snap, errs));
+    sol->add_ishell(process_gml_surface(it->node(), id, dallpoly, ctx));
     id++;
   }
   return sol;
 }
 
 
-MultiSolid* process_gml_multisolid(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs)
+MultiSolid* process_gml_multisolid(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx)
 {
   MultiSolid* ms = new MultiSolid;
   if (nms.attribute("gml:id") != 0)
     ms->set_id(std::string(nms.attribute("gml:id").value()));
-  std::string s = ".//" + NS["gml"] + "Solid";
+  std::string s = ".//" + ctx.ns("gml") + "Solid";
   pugi::xpath_node_set nn = nms.select_nodes(s.c_str());
   for (pugi::xpath_node_set::const_iterator it = nn.begin(); it != nn.end(); ++it)
   {
-    Solid* s = process_gml_solid(it->node(), dallpoly, tol_snap, errs);
+    Solid* s = process_gml_solid(it->node(), dallpoly, ctx);
     if (s->get_id() == "")
       s->set_id(std::to_string(ms->number_of_solids()));
     ms->add_solid(s);
@@ -355,16 +350,16 @@ MultiSolid* process_gml_multisolid(const pugi::xml_node& nms, std::map<std::stri
 }
 
 
-CompositeSolid* process_gml_compositesolid(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs)
+CompositeSolid* process_gml_compositesolid(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx)
 {
   CompositeSolid* cs = new CompositeSolid;
   if (nms.attribute("gml:id") != 0)
     cs->set_id(std::string(nms.attribute("gml:id").value()));
-  std::string s = ".//" + NS["gml"] + "Solid";
+  std::string s = ".//" + ctx.ns("gml") + "Solid";
   pugi::xpath_node_set nn = nms.select_nodes(s.c_str());
   for (pugi::xpath_node_set::const_iterator it = nn.begin(); it != nn.end(); ++it)
   {
-    Solid* s = process_gml_solid(it->node(), dallpoly, tol_snap, errs);
+    Solid* s = process_gml_solid(it->node(), dallpoly, ctx);
     if (s->get_id() == "")
       s->set_id(std::to_string(cs->number_of_solids()));
     cs->add_solid(s);
@@ -375,22 +370,22 @@ CompositeSolid* process_gml_compositesolid(const pugi::xml_node& nms, std::map<s
 
 
 
-MultiSurface* process_gml_multisurface(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs)
+MultiSurface* process_gml_multisurface(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx)
 {
   MultiSurface* ms = new MultiSurface;
   if (nms.attribute("gml:id") != 0)
     ms->set_id(std::string(nms.attribute("gml:id").value()));
-  Surface* s = process_gml_surface(nms, 0, dallpoly, tol_snap, errs);
+  Surface* s = process_gml_surface(nms, 0, dallpoly, ctx);
   ms->set_surface(s);
   return ms;
 }
 
-CompositeSurface* process_gml_compositesurface(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs)
+CompositeSurface* process_gml_compositesurface(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx)
 {
   CompositeSurface* cs = new CompositeSurface;
   if (nms.attribute("gml:id") != 0)
     cs->set_id(std::string(nms.attribute("gml:id").value()));
-  Surface* s = process_gml_surface(nms, 0, dallpoly, tol_snap, errs);
+  Surface* s = process_gml_surface(nms, 0, dallpoly, ctx);
   cs->set_surface(s);
   return cs;
 }
@@ -405,45 +400,45 @@ void print_information(std::string &ifile)
     return;
   }
   //-- parse namespace
-  std::map<std::string, std::string> ns;
+  ValidationContext ctx;
   pugi::xml_node ncm = doc.first_child();
   std::string vcitygml;
-  get_namespaces(ncm, vcitygml);
+  get_namespaces(ncm, ctx, vcitygml);
   if (vcitygml.empty() == true) {
     std::cout << "File does not have the CityGML namespace. Abort." << std::endl;
     return;
   }
   std::cout << "++++++++++++++++++++ GENERAL +++++++++++++++++++++" << std::endl;
   std::cout << "CityGML version: " << vcitygml << std::endl;
-  report_primitives(doc);
-  report_building(doc);
+  report_primitives(doc, ctx);
+  report_building(doc, ctx);
 }
 
-void report_building(pugi::xml_document& doc) {
+void report_building(pugi::xml_document& doc, ValidationContext& ctx) {
   std::cout << "++++++++++++++++++++ BUILDINGS +++++++++++++++++++" << std::endl;
   
-  std::string s = "//" + NS["building"] + "Building";
+  std::string s = "//" + ctx.ns("building") + "Building";
   int nobuildings = doc.select_nodes(s.c_str()).size();
   print_info_aligned("Building", nobuildings);
 
-  s = "//" + NS["building"] + "Building" + "/" + NS["building"] + "consistsOfBuildingPart" + "[1]";
+  s = "//" + ctx.ns("building") + "Building" + "/" + ctx.ns("building") + "consistsOfBuildingPart" + "[1]";
   int nobwbp = doc.select_nodes(s.c_str()).size();
   print_info_aligned("without BuildingPart", (nobuildings - nobwbp), true);
   print_info_aligned("having BuildingPart", nobwbp, true);
-  s = "//" + NS["building"] + "Building" + "[@" + NS["gml"] + "id]";
+  s = "//" + ctx.ns("building") + "Building" + "[@" + ctx.ns("gml") + "id]";
   print_info_aligned("with gml:id", doc.select_nodes(s.c_str()).size(), true);
 
-  s = "//" + NS["building"] + "BuildingPart";
+  s = "//" + ctx.ns("building") + "BuildingPart";
   int nobuildingparts = doc.select_nodes(s.c_str()).size();
   print_info_aligned("BuildingPart", nobuildingparts);
-  s = "//" + NS["building"] + "BuildingPart" + "[@" + NS["gml"] + "id]";
+  s = "//" + ctx.ns("building") + "BuildingPart" + "[@" + ctx.ns("gml") + "id]";
   print_info_aligned("with gml:id", doc.select_nodes(s.c_str()).size(), true);
   for (int lod = 1; lod <= 3; lod++) {
     std::cout << "LOD" << lod << std::endl;
     int totals = 0;
     int totalms = 0;
     int totalsem = 0;
-    report_building_each_lod(doc, lod, totals, totalms, totalsem);
+    report_building_each_lod(doc, ctx, lod, totals, totalms, totalsem);
     print_info_aligned("Building stored in gml:Solid", totals, true);
     print_info_aligned("Building stored in gml:MultiSurface", totalms, true);
     print_info_aligned("Building with semantics for surfaces", totalsem, true);
@@ -459,15 +454,15 @@ void print_info_aligned(std::string o, size_t number, bool tab) {
   std::cout << std::setw(10) << std::right << number << std::endl;
 }
 
-void report_building_each_lod(pugi::xml_document& doc, int lod, int& total_solid, int& total_ms, int& total_sem) {
+void report_building_each_lod(pugi::xml_document& doc, ValidationContext& ctx, int lod, int& total_solid, int& total_ms, int& total_sem) {
   total_solid = 0;
   total_ms = 0;
   total_sem = 0;
   std::string slod = "lod" + std::to_string(lod);
-  std::string s = "//" + NS["building"] + "Building";
+  std::string s = "//" + ctx.ns("building") + "Building";
   pugi::xpath_node_set nb = doc.select_nodes(s.c_str());
   for (auto& b : nb) {
-    std::string s1 = ".//" + NS["building"] + slod + "Solid";
+    std::string s1 = ".//" + ctx.ns("building") + slod + "Solid";
     pugi::xpath_node_set tmp = b.node().select_nodes(s1.c_str());
     if (tmp.empty() == false) {
       for (auto& nbp : tmp) {
@@ -475,7 +470,7 @@ void report_building_each_lod(pugi::xml_document& doc, int lod, int& total_solid
         break;
       }
     }
-    s1 = ".//" + NS["building"] + slod + "MultiSurface";
+    s1 = ".//" + ctx.ns("building") + slod + "MultiSurface";
     tmp = b.node().select_nodes(s1.c_str());
     if (tmp.empty() == false) {
       for (auto& nbp : tmp) {
@@ -483,7 +478,7 @@ void report_building_each_lod(pugi::xml_document& doc, int lod, int& total_solid
         break;
       }
     }
-    s1 = ".//" + NS["building"] + "boundedBy" + "//" + NS["building"] + slod + "MultiSurface";
+    s1 = ".//" + ctx.ns("building") + "boundedBy" + "//" + ctx.ns("building") + slod + "MultiSurface";
     tmp = b.node().select_nodes(s1.c_str());
     if (tmp.empty() == false) {
       for (auto& nbp : tmp) {
@@ -495,108 +490,60 @@ void report_building_each_lod(pugi::xml_document& doc, int lod, int& total_solid
 }
 
 
-void get_namespaces(pugi::xml_node& root, std::map<std::string, std::string>& ns, std::string& vcitygml) {
-  vcitygml = "";
-  for (pugi::xml_attribute attr = root.first_attribute(); attr; attr = attr.next_attribute()) {
-    std::string name = attr.name();
-    if (name.find("xmlns") != std::string::npos) {
-      std::string value = attr.value();
-      std::string sns;
-      if (value.find("http://www.opengis.net/citygml/0") != std::string::npos) {
-        sns = "citygml";
-        vcitygml = "v0.4";
-      }
-      else if (value.find("http://www.opengis.net/citygml/1") != std::string::npos) {
-        sns = "citygml";
-        vcitygml = "v1.0";
-      }
-      else if (value.find("http://www.opengis.net/citygml/2") != std::string::npos) {
-        sns = "citygml";
-        vcitygml = "v2.0";
-      }
-      else if ( (value.find("http://www.opengis.net/gml") != std::string::npos) &&
-                (value.find("http://www.opengis.net/gmlcov") == std::string::npos) ) {
-          sns = "gml";
-      }
-      else if (value.find("http://www.opengis.net/citygml/building") != std::string::npos)
-        sns = "building";
-      else if (value.find("http://www.w3.org/1999/xlink") != std::string::npos)
-        sns = "xlink";
-      else
-        sns = "";
-      if (sns != "") {
-        size_t pos = name.find(":");
-        if (pos == std::string::npos) 
-          ns[sns] = "";
-        else 
-          ns[sns] = name.substr(pos + 1) + ":";
-      }    
-    }
-  }
-}
-
-
-
-void report_primitives(pugi::xml_document& doc) {
+void report_primitives(pugi::xml_document& doc, ValidationContext& ctx) {
   std::cout << "+++++++++++++++++++ PRIMITIVES +++++++++++++++++++" << std::endl;
   
-  std::string s = "//" + NS["gml"] + "Solid";
+  std::string s = "//" + ctx.ns("gml") + "Solid";
   print_info_aligned("gml:Solid", doc.select_nodes(s.c_str()).size());
 
-  s = "//" + NS["gml"] + "MultiSolid";
+  s = "//" + ctx.ns("gml") + "MultiSolid";
   print_info_aligned("gml:MultiSolid", doc.select_nodes(s.c_str()).size());
 
-  s = "//" + NS["gml"] + "CompositeSolid";
+  s = "//" + ctx.ns("gml") + "CompositeSolid";
   print_info_aligned("gml:CompositeSolid", doc.select_nodes(s.c_str()).size());
   
-  s = "//" + NS["gml"] + "MultiSurface";
+  s = "//" + ctx.ns("gml") + "MultiSurface";
   print_info_aligned("gml:MultiSurface", doc.select_nodes(s.c_str()).size());
   
-  s = "//" + NS["gml"] + "CompositeSurface";
+  s = "//" + ctx.ns("gml") + "CompositeSurface";
   print_info_aligned("gml:CompositeSurface", doc.select_nodes(s.c_str()).size());
 
-  s = "//" + NS["gml"] + "Polygon";
+  s = "//" + ctx.ns("gml") + "Polygon";
   print_info_aligned("gml:Polygon", doc.select_nodes(s.c_str()).size());
 
   std::cout << std::endl;
 }
 
 
-void process_json_surface(std::vector< std::vector<int> >& pgn, json& j, Surface* sh)
+//-- the ring indices are read from the JSON arrays straight into the face of sh
+void process_json_surface(const json& pgn, const std::vector<double>& vertices, Surface* sh, ValidationContext& ctx)
 {
-  std::vector< std::vector<int> > pgnids;
+  sh->add_face();
   for (auto& r : pgn)
   {
-    std::vector<int> newr;
-    for (auto& i : r)
+    sh->add_ring();
+    for (auto& v : r)
     {
-      double x;
-      double y;
-      double z;
-      if (j.count("transform") == 0)
+      int i = v.get<int>();
+      int id = sh->get_point_id(i);
+      if (id != -1)
       {
-        x = double(j["vertices"][i][0]);
-        y = double(j["vertices"][i][1]);
-        z = double(j["vertices"][i][2]);
+        sh->add_ring_vertex(id);
+        continue;
       }
-      else
+      if ( (i < 0) || ((3 * size_t(i) + 2) >= vertices.size()) )
       {
-        x = (double(j["vertices"][i][0]) * double(j["transform"]["scale"][0])) + double(j["transform"]["translate"][0]);
-        y = (double(j["vertices"][i][1]) * double(j["transform"]["scale"][1])) + double(j["transform"]["translate"][1]);
-        z = (double(j["vertices"][i][2]) * double(j["transform"]["scale"][2])) + double(j["transform"]["translate"][2]);
+        ctx.get_io_errors().add_error(901, "Vertex index " + std::to_string(i) + " is not in the vertices of the file.");
+        continue;
       }
-      x -= _minx;
-      y -= _miny;
-      Point3 p3(x, y, z);
-      newr.push_back(sh->add_point(p3));
+      Point3 p3(vertices[3 * i], vertices[3 * i + 1], vertices[3 * i + 2]);
+      sh->add_ring_vertex(sh->add_point(p3, i));
     }
-    pgnids.push_back(newr);
   }
-  sh->add_face(pgnids);
 }
 
 
-void process_json_geometries_of_co(json& jco, CityObject* co, std::vector<GeometryTemplate*>& lsGTs, json& j, double tol_snap)
+void process_json_geometries_of_co(json& jco, CityObject* co, std::vector<GeometryTemplate*>& lsGTs, const std::vector<double>& vertices, ValidationContext& ctx)
 {
   int idgeom = co->number_of_primitives();
   for (auto& g : jco["geometry"]) {
@@ -608,11 +555,10 @@ void process_json_geometries_of_co(json& jco, CityObject* co, std::vector<Geomet
       int c = 0;
       for (auto& shell : g["boundaries"]) 
       {
-        Surface* sh = new Surface(c, tol_snap);
+        Surface* sh = new Surface(ctx, c);
         c++;
         for (auto& polygon : shell) { 
-          std::vector< std::vector<int> > pa = polygon;
-          process_json_surface(pa, j, sh);
+          process_json_surface(polygon, vertices, sh, ctx);
         }
         if (oshell == true)
         {
@@ -626,11 +572,10 @@ void process_json_geometries_of_co(json& jco, CityObject* co, std::vector<Geomet
     }
     else if ( (g["type"] == "MultiSurface") || (g["type"] == "CompositeSurface") ) 
     {
-      Surface* sh = new Surface(-1, tol_snap);
+      Surface* sh = new Surface(ctx, -1);
       for (auto& p : g["boundaries"]) 
       { 
-        std::vector< std::vector<int> > pa = p;
-        process_json_surface(pa, j, sh);
+        process_json_surface(p, vertices, sh, ctx);
       }
       if (g["type"] == "MultiSurface")
       {
@@ -654,10 +599,9 @@ void process_json_geometries_of_co(json& jco, CityObject* co, std::vector<Geomet
         bool oshell = true;
         for (auto& shell : solid) 
         {
-          Surface* sh = new Surface(-1, tol_snap);
+          Surface* sh = new Surface(ctx, -1);
           for (auto& polygon : shell) { 
-            std::vector< std::vector<int> > pa = polygon;
-            process_json_surface(pa, j, sh);
+            process_json_surface(polygon, vertices, sh, ctx);
           }
           if (oshell == true)
           {
@@ -680,10 +624,9 @@ void process_json_geometries_of_co(json& jco, CityObject* co, std::vector<Geomet
         bool oshell = true;
         for (auto& shell : solid) 
         {
-          Surface* sh = new Surface(-1, tol_snap);
+          Surface* sh = new Surface(ctx, -1);
           for (auto& polygon : shell) { 
-            std::vector< std::vector<int> > pa = polygon;
-            process_json_surface(pa, j, sh);
+            process_json_surface(polygon, vertices, sh, ctx);
           }
           if (oshell == true)
           {
@@ -707,7 +650,7 @@ void process_json_geometries_of_co(json& jco, CityObject* co, std::vector<Geomet
   }
 }
 
-void read_file_cityjson(std::string &ifile, std::vector<Feature*>& lsFeatures, IOErrors& errs, double tol_snap)
+void read_file_cityjson(std::string &ifile, std::vector<Feature*>& lsFeatures, ValidationContext& ctx)
 {
   std::ifstream input(ifile);
   json j;
@@ -717,46 +660,322 @@ void read_file_cityjson(std::string &ifile, std::vector<Feature*>& lsFeatures, I
   }
   catch (nlohmann::detail::parse_error e) 
   {
-    errs.add_error(901, "Input file not a valid JSON file.");
+    ctx.get_io_errors().add_error(901, "Input file not a valid JSON file.");
     return;
   }
   // TODO: other validation for CityJSON or just let it crash?
   if (j["type"] != "CityJSON") {
-    errs.add_error(901, "Input file not a CityJSON file.");
+    ctx.get_io_errors().add_error(901, "Input file not a CityJSON file.");
     return;  
   }
   std::cout << "CityJSON input file" << std::endl;
   std::cout << "# City Objects found: " << j["CityObjects"].size() << std::endl;
-  //-- compute (_minx, _miny)
-  compute_min_xy(j);
+  //-- decode the vertices once, translated by (minx, miny)
+  std::vector<double> vertices;
+  decode_cityjson_vertices(j, vertices, ctx);
   //-- read and store the GeometryTemplates
   std::vector<GeometryTemplate*> lsGTs;
   if (j.count("geometry-templates") == 1)
   {
-    process_cityjson_geometrytemplates(j["geometry-templates"], lsGTs, tol_snap);
+    process_cityjson_geometrytemplates(j["geometry-templates"], lsGTs, ctx);
   }
   //-- process each CO
-  for (json::iterator it = j["CityObjects"].begin(); it != j["CityObjects"].end(); ++it) 
+  process_cityjson_cityobjects(j["CityObjects"], lsGTs, vertices, ctx, 
+                               [&](CityObject* co) { lsFeatures.push_back(co); });
+}
+
+
+//-- builds each CO of jcos (BuildingParts are put in their Building) and
+//-- hands it to process()
+void process_cityjson_cityobjects(json& jcos, 
+                                  std::vector<GeometryTemplate*>& lsGTs, 
+                                  const std::vector<double>& vertices, 
+                                  ValidationContext& ctx, 
+                                  std::function<void(CityObject*)> process)
+{
+  for (json::iterator it = jcos.begin(); it != jcos.end(); ++it) 
   {
     //-- BuildingParts geometries are put with those of a Building
     if (it.value()["type"] == "BuildingPart")
       continue;
     CityObject* co = new CityObject(it.key(), it.value()["type"]);
-    process_json_geometries_of_co(it.value(), co, lsGTs, j, tol_snap);
+    process_json_geometries_of_co(it.value(), co, lsGTs, vertices, ctx);
     //-- if Building has Parts, put them here in _lsPrimitives
     if ( (it.value()["type"] == "Building") && (it.value().count("children") != 0) ) 
     {
       for (std::string bpid : it.value()["children"])
       {
-        process_json_geometries_of_co(j["CityObjects"][bpid], co, lsGTs, j, tol_snap);
+        if (jcos.count(bpid) != 0)
+          process_json_geometries_of_co(jcos[bpid], co, lsGTs, vertices, ctx);
+      }
+    }
+    process(co);
+  }
+}
+
+
+//-- reads a CityJSONSeq file (https://www.cityjson.org/cityjsonseq/): the first
+//-- line is a CityJSON object with the transform (and the geometry-templates, 
+//-- read with the 1st feature), each of the other lines is a CityJSONFeature 
+//-- with its own vertices. The features are read one at a time and their COs 
+//-- handed to process()
+void read_file_cityjsonseq(std::string &ifile, 
+                           ValidationContext& ctx, 
+                           std::vector<GeometryTemplate*>& lsGTs, 
+                           std::function<void(CityObject*)> process)
+{
+  std::ifstream input(ifile);
+  std::string line;
+  json jh;
+  try 
+  {
+    std::getline(input, line);
+    jh = json::parse(line);
+  }
+  catch (nlohmann::detail::parse_error e) 
+  {
+    ctx.get_io_errors().add_error(901, "First line of input file not a valid JSON object.");
+    return;
+  }
+  if (jh["type"] != "CityJSON") {
+    ctx.get_io_errors().add_error(901, "First line of input file not a CityJSON object.");
+    return;  
+  }
+  std::cout << "CityJSONSeq input file" << std::endl;
+  std::vector<double> vertices;
+  bool translated = false;
+  int noline = 1;
+  int nofeatures = 0;
+  while (std::getline(input, line))
+  {
+    noline++;
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+    json jf;
+    try 
+    {
+      jf = json::parse(line);
+    }
+    catch (nlohmann::detail::parse_error e) 
+    {
+      ctx.get_io_errors().add_error(901, "Line " + std::to_string(noline) + " of input file not a valid JSON object.");
+      return;
+    }
+    if (jf["type"] != "CityJSONFeature") {
+      ctx.get_io_errors().add_error(901, "Line " + std::to_string(noline) + " of input file not a CityJSONFeature.");
+      return;  
+    }
+    //-- the vertices are local to the feature, the translation is that of the 1st one
+    vertices.clear();
+    vertices.reserve(3 * jf["vertices"].size());
+    for (auto& v : jf["vertices"])
+    {
+      for (int k = 0; k < 3; k++)
+        vertices.push_back(v.at(k).get<double>());
+    }
+    bool update = ( (translated == false) && (vertices.empty() == false) );
+    transform_cityjson_vertices(jh, vertices, ctx, update);
+    translated = (translated || update);
+    //-- the GeometryTemplates are read (as in a CityJSON file) once the
+    //-- translation is known, it is that of their Surfaces
+    if ( (nofeatures == 0) && (jh.count("geometry-templates") == 1) )
+    {
+      process_cityjson_geometrytemplates(jh["geometry-templates"], lsGTs, ctx);
+    }
+    process_cityjson_cityobjects(jf["CityObjects"], lsGTs, vertices, ctx, process);
+    nofeatures++;
+  }
+  std::cout << "# CityJSONFeatures read: " << nofeatures << std::endl;
+}
+
+
+//-- nlohmann::json loses track of the depth once a parser callback skips a
+//-- value, the callback returned keeps its own count and passes it to f
+json::parser_callback_t track_depth(std::function<bool(int, json::parse_event_t, json&)> f)
+{
+  std::shared_ptr<int> d = std::make_shared<int>(0);
+  return [d, f](int, json::parse_event_t event, json& parsed) -> bool
+  {
+    if ( (event == json::parse_event_t::object_start) || (event == json::parse_event_t::array_start) )
+    {
+      bool keep = f(*d, event, parsed);
+      if (keep == true)
+        (*d)++;
+      return keep;
+    }
+    if ( (event == json::parse_event_t::object_end) || (event == json::parse_event_t::array_end) )
+    {
+      //-- the end of a skipped empty array is reported with a discarded value
+      if (parsed.is_discarded() == true)
+        return false;
+      (*d)--;
+    }
+    return f(*d, event, parsed);
+  };
+}
+
+
+//-- reads a CityJSON file without keeping its City Objects in memory: a first 
+//-- pass reads everything but the geometries of the City Objects (the vertices
+//-- are decoded on the fly), a second one builds each City Object as soon as
+//-- it is complete and hands it to process(). A Building with children waits 
+//-- for them. The GeometryTemplates are returned in lsGTs, the caller frees them 
+//-- once all the City Objects are validated.
+void read_file_cityjson_stream(std::string &ifile, 
+                               ValidationContext& ctx, 
+                               std::vector<GeometryTemplate*>& lsGTs, 
+                               std::function<void(CityObject*)> process)
+{
+  //-- 1. vertices, transform, geometry-templates and which City Objects are children
+  std::vector<double> vertices;
+  std::map<std::string, std::string> parentof;
+  std::string topkey;
+  std::string coid;
+  std::string cokey;
+  int nco = 0;
+  json::parser_callback_t cb1 = track_depth([&](int depth, json::parse_event_t event, json& parsed) -> bool
+  {
+    if ( (depth == 1) && (event == json::parse_event_t::key) )
+      topkey = parsed;
+    else if (topkey == "vertices")
+    {
+      //-- each vertex is decoded and discarded
+      if ( (depth == 2) && (event == json::parse_event_t::array_end) )
+      {
+        for (int k = 0; k < 3; k++)
+          vertices.push_back(parsed.at(k).get<double>());
+        return false;
+      }
+    }
+    else if (topkey == "CityObjects")
+    {
+      if ( (depth == 2) && (event == json::parse_event_t::key) )
+      {
+        cokey = parsed;
+        coid = cokey;
+        nco++;
+      }
+      else if ( (depth == 3) && (event == json::parse_event_t::key) )
+        cokey = parsed;
+      else if ( (depth == 3) && (cokey == "geometry") &&
+                ((event == json::parse_event_t::array_start) || (event == json::parse_event_t::object_start)) )
+        return false;
+      else if ( (depth == 2) && (event == json::parse_event_t::object_end) )
+      {
+        if ( (parsed["type"] == "Building") && (parsed.count("children") != 0) )
+        {
+          for (auto& c : parsed["children"])
+            parentof[c.get<std::string>()] = coid;
+        }
+        return false;
       }
     }
-    lsFeatures.push_back(co);
+    return true;
+  });
+  std::ifstream input(ifile);
+  json j;
+  try 
+  {
+    j = json::parse(input, cb1);
+  }
+  catch (nlohmann::detail::parse_error e) 
+  {
+    ctx.get_io_errors().add_error(901, "Input file not a valid JSON file.");
+    return;
+  }
+  if (j["type"] != "CityJSON") {
+    ctx.get_io_errors().add_error(901, "Input file not a CityJSON file.");
+    return;  
+  }
+  std::cout << "CityJSON input file (streamed)" << std::endl;
+  std::cout << "# City Objects found: " << nco << std::endl;
+  transform_cityjson_vertices(j, vertices, ctx);
+  if (j.count("geometry-templates") == 1)
+  {
+    process_cityjson_geometrytemplates(j["geometry-templates"], lsGTs, ctx);
   }
+  //-- 2. the City Objects
+  std::map<std::string, json> buildings; //-- Buildings waiting for their children
+  std::map<std::string, json> children;
+  auto complete_building = [&](std::string bid)
+  {
+    json& b = buildings[bid];
+    CityObject* co = new CityObject(bid, b["type"]);
+    process_json_geometries_of_co(b, co, lsGTs, vertices, ctx);
+    for (std::string bpid : b["children"])
+    {
+      if (children.count(bpid) == 0)
+        continue;
+      process_json_geometries_of_co(children[bpid], co, lsGTs, vertices, ctx);
+      children.erase(bpid);
+    }
+    buildings.erase(bid);
+    process(co);
+  };
+  auto is_building_complete = [&](std::string bid)
+  {
+    if (buildings.count(bid) == 0)
+      return false;
+    for (std::string bpid : buildings[bid]["children"])
+      if (children.count(bpid) == 0)
+        return false;
+    return true;
+  };
+  json::parser_callback_t cb2 = track_depth([&](int depth, json::parse_event_t event, json& parsed) -> bool
+  {
+    if ( (depth == 1) && (event == json::parse_event_t::key) )
+    {
+      topkey = parsed;
+      return true;
+    }
+    if (topkey != "CityObjects")
+    {
+      //-- everything else was read in the first pass
+      if ( (depth == 1) && ((event == json::parse_event_t::array_start) || (event == json::parse_event_t::object_start)) )
+        return false;
+      return true;
+    }
+    if ( (depth == 2) && (event == json::parse_event_t::key) )
+      coid = parsed;
+    else if ( (depth == 2) && (event == json::parse_event_t::object_end) )
+    {
+      //-- BuildingParts geometries are put with those of a Building
+      if (parsed["type"] != "BuildingPart") 
+      {
+        if ( (parsed["type"] == "Building") && (parsed.count("children") != 0) )
+        {
+          buildings[coid] = parsed;
+          if (is_building_complete(coid) == true)
+            complete_building(coid);
+        }
+        else
+        {
+          CityObject* co = new CityObject(coid, parsed["type"]);
+          process_json_geometries_of_co(parsed, co, lsGTs, vertices, ctx);
+          process(co);
+        }
+      }
+      auto it = parentof.find(coid);
+      if (it != parentof.end())
+      {
+        children[coid] = parsed;
+        if (is_building_complete(it->second) == true)
+          complete_building(it->second);
+      }
+      return false;
+    }
+    return true;
+  });
+  std::ifstream input2(ifile);
+  topkey = "";
+  json::parse(input2, cb2);
+  //-- Buildings with children that are not in the file
+  while (buildings.empty() == false)
+    complete_building(buildings.begin()->first);
 }
 
 
-void process_cityjson_geometrytemplates(json& j, std::vector<GeometryTemplate*>& lsGTs, double tol_snap)
+void process_cityjson_geometrytemplates(json& j, std::vector<GeometryTemplate*>& lsGTs, ValidationContext& ctx)
 {
   int count = 0;
   for (auto& jt : j["templates"])
@@ -769,11 +988,10 @@ void process_cityjson_geometrytemplates(json& j, std::vector<GeometryTemplate*>&
       int c = 0;
       for (auto& shell : jt["boundaries"]) 
       {
-        Surface* sh = new Surface(c, tol_snap);
+        Surface* sh = new Surface(ctx, c);
         c++;
         for (auto& polygon : shell) { 
-          std::vector< std::vector<int> > pa = polygon;
-          process_json_surface_geometrytemplate(pa, j, sh);
+          process_json_surface_geometrytemplate(polygon, j, sh);
         }
         if (oshell == true)
         {
@@ -787,11 +1005,10 @@ void process_cityjson_geometrytemplates(json& j, std::vector<GeometryTemplate*>&
     }
     else if ( (jt["type"] == "MultiSurface") || (jt["type"] == "CompositeSurface") ) 
     {
-      Surface* sh = new Surface(-1, tol_snap);
+      Surface* sh = new Surface(ctx, -1);
       for (auto& p : jt["boundaries"]) 
       { 
-        std::vector< std::vector<int> > pa = p;
-        process_json_surface_geometrytemplate(pa, j, sh);
+        process_json_surface_geometrytemplate(p, j, sh);
       }
       if (jt["type"] == "MultiSurface")
       {
@@ -812,30 +1029,36 @@ void process_cityjson_geometrytemplates(json& j, std::vector<GeometryTemplate*>&
 }
 
 
-void process_json_surface_geometrytemplate(std::vector< std::vector<int> >& pgn, json& j, Surface* sh)
+void process_json_surface_geometrytemplate(const json& pgn, json& j, Surface* sh)
 {
-  std::vector< std::vector<int> > pgnids;
+  const json& jv = j["vertices-templates"];
+  sh->add_face();
   for (auto& r : pgn)
   {
-    std::vector<int> newr;
-    for (auto& i : r)
+    sh->add_ring();
+    for (auto& v : r)
     {
+      int i = v.get<int>();
+      int id = sh->get_point_id(i);
+      if (id != -1)
+      {
+        sh->add_ring_vertex(id);
+        continue;
+      }
       double x;
       double y;
       double z;
-      x = double(j["vertices-templates"][i][0]);
-      y = double(j["vertices-templates"][i][1]);
-      z = double(j["vertices-templates"][i][2]);
+      x = double(jv[i][0]);
+      y = double(jv[i][1]);
+      z = double(jv[i][2]);
       Point3 p3(x, y, z);
-      newr.push_back(sh->add_point(p3));
+      sh->add_ring_vertex(sh->add_point(p3, i));
     }
-    pgnids.push_back(newr);
   }
-  sh->add_face(pgnids);
 }
 
 
-void process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, IOErrors& errs, double tol_snap)
+void process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx)
 {
   //-- 0. read the header of the file and find its gml:name, if any
   std::string nameim = "";
@@ -848,7 +1071,7 @@ void process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>&
     
   //-- 1. read each cellSpaceMember in the file (the primal objects)
   //--    these can have different names, depending on the Extensions/ADEs used
-  std::string s = ".//" + NS["indoorgml"] + "cellSpaceMember";
+  std::string s = ".//" + ctx.ns("indoorgml") + "cellSpaceMember";
   pugi::xpath_node_set nn = doc.select_nodes(s.c_str());
   int pcounter = 0;
   for (pugi::xpath_node_set::const_iterator it = nn.begin(); it != nn.end(); ++it)
@@ -864,7 +1087,7 @@ void process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>&
     else 
       theid = ("MISSING_ID_" + std::to_string(pcounter));
     //-- get the duality pointer (max one, sweet)
-    s = NS["indoorgml"] + "duality";
+    s = ctx.ns("indoorgml") + "duality";
     for (pugi::xml_node child : cs.children(s.c_str()))
     {
       if (child.attribute("xlink:href") != 0) {
@@ -876,18 +1099,18 @@ void process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>&
     }
     // IndoorCell* cell = new IndoorCell(theid, duality);
     //-- get the geometry, either Solid or Surface
-    s = NS["indoorgml"] + "cellSpaceGeometry";
+    s = ctx.ns("indoorgml") + "cellSpaceGeometry";
     Solid* sol;
     for (pugi::xml_node child : cs.children(s.c_str()))
     {
-      s = NS["indoorgml"] + "Geometry3D";
+      s = ctx.ns("indoorgml") + "Geometry3D";
       for (pugi::xml_node child2 : child.children(s.c_str()))
       {
-        s = NS["gml"] + "Solid";
+        s = ctx.ns("gml") + "Solid";
         for (pugi::xml_node child3 : child2.children(s.c_str()))
         {
           // std::cout << "Solid: " << child3.attribute("gml:id").value() << std::endl;
-          sol = process_gml_solid(child3, dallpoly, tol_snap, errs);
+          sol = process_gml_solid(child3, dallpoly, ctx);
           if (sol->get_id() == "")
             sol->set_id("MISSING_ID");
           // cell->add_primitive(sol);
@@ -899,7 +1122,7 @@ void process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>&
   }
 
   //-- 2. read the dual graphs (yes there can be more than one) 
-  s = ".//" + NS["indoorgml"] + "SpaceLayer";
+  s = ".//" + ctx.ns("indoorgml") + "SpaceLayer";
   nn = doc.select_nodes(s.c_str());
   for (pugi::xpath_node_set::const_iterator it = nn.begin(); it != nn.end(); ++it)
   {
@@ -913,12 +1136,12 @@ void process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>&
     IndoorGraph* ig = new IndoorGraph(idg);
     //-- fetch all the edges
     std::map<std::string, std::tuple<std::string,std::string>> edges;
-    s = ".//" + NS["indoorgml"] + "Transition";
+    s = ".//" + ctx.ns("indoorgml") + "Transition";
     pugi::xpath_node_set ntr = it->node().select_nodes(s.c_str());
     for (pugi::xpath_node_set::const_iterator it = ntr.begin(); it != ntr.end(); ++it)
     {
       std::string theid = it->node().attribute("gml:id").value();
-      s = NS["indoorgml"] + "connects";
+      s = ctx.ns("indoorgml") + "connects";
       std::vector<std::string> connects;
       for (pugi::xml_node child : it->node().children(s.c_str()))
       {
@@ -932,14 +1155,14 @@ void process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>&
       edges[theid] = std::make_tuple(connects[0], connects[1]);
     }
     //-- fetch all the nodes
-    s = ".//" + NS["indoorgml"] + "State";
+    s = ".//" + ctx.ns("indoorgml") + "State";
     pugi::xpath_node_set nstate = it->node().select_nodes(s.c_str());
 //    pugi::xpath_node_set nstate = doc.select_nodes(s.c_str());
     for (pugi::xpath_node_set::const_iterator it = nstate.begin(); it != nstate.end(); ++it)
     {
       // std::cout << "---\n" << it->node().attribute("gml:id").value() << std::endl;
       std::string vid = it->node().attribute("gml:id").value();
-      s = NS["indoorgml"] + "duality";
+      s = ctx.ns("indoorgml") + "duality";
       std::string vdual;
       pugi::xml_node child = it->node().child(s.c_str());
       if (child.attribute("xlink:href") != 0) {
@@ -948,7 +1171,7 @@ void process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>&
           vdual = vdual.substr(1);
         // std::cout << "dual node: " << vdual << std::endl;
       }
-      s = NS["indoorgml"] + "connects";
+      s = ctx.ns("indoorgml") + "connects";
       std::vector<std::string> vadj;
       for (pugi::xml_node child : it->node().children(s.c_str()))
       {
@@ -960,7 +1183,7 @@ void process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>&
             vadj.push_back(std::get<1>(edges[s]));
         }
       }
-      s = ".//" + NS["gml"] + "pos";
+      s = ".//" + ctx.ns("gml") + "pos";
       pugi::xpath_node n = it->node().select_node(s.c_str());
       // std::cout << n.node().child_value() << std::endl;
       
@@ -989,7 +1212,7 @@ void process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>&
 
 
 
-void process_gml_file_primitives(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, IOErrors& errs, double tol_snap)
+void process_gml_file_primitives(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx)
 {
   primitives_walker walker;
   doc.traverse(walker);
@@ -1001,35 +1224,35 @@ void process_gml_file_primitives(pugi::xml_document& doc, std::vector<Feature*>&
   {
     if (remove_xml_namespace(prim.name()).compare("Solid") == 0)
     {
-      Solid* p = process_gml_solid(prim, dallpoly, tol_snap, errs);
+      Solid* p = process_gml_solid(prim, dallpoly, ctx);
       if (p->get_id().compare("") == 0)
         p->set_id(std::to_string(primid));
       o->add_primitive(p);
     }
     else if (remove_xml_namespace(prim.name()).compare("MultiSolid") == 0)
     {
-      MultiSolid* p = process_gml_multisolid(prim, dallpoly, tol_snap, errs);
+      MultiSolid* p = process_gml_multisolid(prim, dallpoly, ctx);
       if (p->get_id().compare("") == 0)
         p->set_id(std::to_string(primid));
       o->add_primitive(p);
     }      
     else if (remove_xml_namespace(prim.name()).compare("CompositeSolid") == 0)
     {
-      CompositeSolid* p = process_gml_compositesolid(prim, dallpoly, tol_snap, errs);
+      CompositeSolid* p = process_gml_compositesolid(prim, dallpoly, ctx);
       if (p->get_id().compare("") == 0)
         p->set_id(std::to_string(primid));
       o->add_primitive(p);
     }
     else if (remove_xml_namespace(prim.name()).compare("MultiSurface") == 0)
     {
-      MultiSurface* p = process_gml_multisurface(prim, dallpoly, tol_snap, errs);
+      MultiSurface* p = process_gml_multisurface(prim, dallpoly, ctx);
       if (p->get_id().compare("") == 0)
         p->set_id(std::to_string(primid));
       o->add_primitive(p);
     } 
     else if (remove_xml_namespace(prim.name()).compare("CompositeSurface") == 0)
     {
-      CompositeSurface* p = process_gml_compositesurface(prim, dallpoly, tol_snap, errs);
+      CompositeSurface* p = process_gml_compositesurface(prim, dallpoly, ctx);
       if (p->get_id().compare("") == 0)
         p->set_id(std::to_string(primid));
       o->add_primitive(p);
@@ -1040,7 +1263,7 @@ void process_gml_file_primitives(pugi::xml_document& doc, std::vector<Feature*>&
 }
 
 
-void process_gml_file_city_objects(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, IOErrors& errs, double tol_snap, bool geom_is_sem_surfaces)
+void process_gml_file_city_objects(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx, bool geom_is_sem_surfaces)
 {
   //-- read each CityObject in the file
   citygml_objects_walker walker;
@@ -1071,7 +1294,7 @@ void process_gml_file_city_objects(pugi::xml_document& doc, std::vector<Feature*
       for (auto& prim : walker3.lsNodes)
       {
         Primitive* p;
-        p = process_gml_multisurface(prim, dallpoly, tol_snap, errs);
+        p = process_gml_multisurface(prim, dallpoly, ctx);
         if (p->get_id() == "")
           p->set_id("MISSING_ID_" + std::to_string(pcounter));
         o->add_primitive(p);
@@ -1083,15 +1306,15 @@ void process_gml_file_city_objects(pugi::xml_document& doc, std::vector<Feature*
       {
         Primitive* p;
         if (remove_xml_namespace(prim.name()).compare("Solid") == 0)
-          p = process_gml_solid(prim, dallpoly, tol_snap, errs);
+          p = process_gml_solid(prim, dallpoly, ctx);
         else if (remove_xml_namespace(prim.name()).compare("MultiSolid") == 0)
-          p = process_gml_multisolid(prim, dallpoly, tol_snap, errs);
+          p = process_gml_multisolid(prim, dallpoly, ctx);
         else if (remove_xml_namespace(prim.name()).compare("CompositeSolid") == 0)
-          p = process_gml_compositesolid(prim, dallpoly, tol_snap, errs);
+          p = process_gml_compositesolid(prim, dallpoly, ctx);
         else if (remove_xml_namespace(prim.name()).compare("MultiSurface") == 0)
-          p = process_gml_multisurface(prim, dallpoly, tol_snap, errs);
+          p = process_gml_multisurface(prim, dallpoly, ctx);
         else if (remove_xml_namespace(prim.name()).compare("CompositeSurface") == 0)
-          p = process_gml_compositesurface(prim, dallpoly, tol_snap, errs);
+          p = process_gml_compositesurface(prim, dallpoly, ctx);
         if (p->get_id() == "")
           p->set_id("MISSING_ID_" + std::to_string(pcounter));
         o->add_primitive(p);
@@ -1103,29 +1326,68 @@ void process_gml_file_city_objects(pugi::xml_document& doc, std::vector<Feature*
 }
 
 
-void compute_min_xy(json& j)
+void compute_min_xy(const std::vector<double>& vertices, ValidationContext& ctx)
+{
+  double minx = 9e15;
+  double miny = 9e15;
+  for (size_t i = 0; i < vertices.size(); i += 3)
+  {
+    if (vertices[i] < minx)
+      minx = vertices[i];
+    if (vertices[i + 1] < miny)
+      miny = vertices[i + 1];
+  }
+  ctx.update_translation(minx, miny);
+  std::cout << "Translating all coordinates by (-" << ctx.get_translation_x() << ", -" << ctx.get_translation_y() << ")" << std::endl;
+}
+
+
+//-- "vertices" of a CityJSON file as x0 y0 z0 x1 y1 z1 ..., with the
+//-- transform applied and translated by (minx, miny)
+void decode_cityjson_vertices(json& j, std::vector<double>& vertices, ValidationContext& ctx)
 {
-  for (auto& v : j["vertices"])
+  const json& jv = j["vertices"];
+  vertices.clear();
+  vertices.reserve(3 * jv.size());
+  for (auto& v : jv)
   {
-    if (v[0] < _minx)
-      _minx = v[0];
-    if (v[1] < _miny)
-      _miny = v[1];
+    for (int k = 0; k < 3; k++)
+      vertices.push_back(v.at(k).get<double>());
   }
+  transform_cityjson_vertices(j, vertices, ctx);
+}
+
+
+//-- applies the "transform" of j (if any) to the vertices, and translates 
+//-- them by (minx, miny); (minx, miny) is first updated with these vertices 
+//-- if update_translation
+void transform_cityjson_vertices(json& j, std::vector<double>& vertices, ValidationContext& ctx, bool update_translation)
+{
   if (j.count("transform") != 0)
   {
-    _minx = (_minx * double(j["transform"]["scale"][0])) + double(j["transform"]["translate"][0]);
-    _miny = (_miny * double(j["transform"]["scale"][1])) + double(j["transform"]["translate"][1]);
+    double scale[3];
+    double translate[3];
+    for (int k = 0; k < 3; k++)
+    {
+      scale[k] = double(j["transform"]["scale"][k]);
+      translate[k] = double(j["transform"]["translate"][k]);
+    }
+    for (size_t i = 0; i < vertices.size(); i++)
+      vertices[i] = (vertices[i] * scale[i % 3]) + translate[i % 3];
+  }
+  if (update_translation == true)
+    compute_min_xy(vertices, ctx);
+  for (size_t i = 0; i < vertices.size(); i += 3)
+  {
+    vertices[i] -= ctx.get_translation_x();
+    vertices[i + 1] -= ctx.get_translation_y();
   }
-  std::cout << "Translating all coordinates by (-" << _minx << ", -" << _miny << ")" << std::endl;
-  Primitive::set_translation_min_values(_minx, _miny);
-  Surface::set_translation_min_values(_minx, _miny);
 }
 
 
-void compute_min_xy(pugi::xml_document& doc)
+void compute_min_xy(pugi::xml_document& doc, ValidationContext& ctx)
 {
-  std::string s = "//" + NS["gml"] + "posList";
+  std::string s = "//" + ctx.ns("gml") + "posList";
   pugi::xpath_node_set nall = doc.select_nodes(s.c_str());
   for (auto& each : nall) 
   {
@@ -1136,13 +1398,10 @@ void compute_min_xy(pugi::xml_document& doc)
       coords.push_back(buf);
     for (int i = 0; i < coords.size(); i += 3)
     {
-      if (std::stod(coords[0]) < _minx)
-        _minx = std::stod(coords[0]);
-      if (std::stod(coords[1]) < _miny)
-        _miny = std::stod(coords[1]);
+      ctx.update_translation(std::stod(coords[0]), std::stod(coords[1]));
     }
   }
-  s = "//" + NS["gml"] + "pos";
+  s = "//" + ctx.ns("gml") + "pos";
   nall = doc.select_nodes(s.c_str());
   for (auto& each : nall) 
   {
@@ -1151,67 +1410,62 @@ void compute_min_xy(pugi::xml_document& doc)
     std::vector<std::string> tokens;
     while (ss >> buf)
       tokens.push_back(buf);
-    if (std::stod(tokens[0]) < _minx)
-      _minx = std::stod(tokens[0]);
-    if (std::stod(tokens[1]) < _miny)
-      _miny = std::stod(tokens[1]);
+    ctx.update_translation(std::stod(tokens[0]), std::stod(tokens[1]));
   }
-  std::cout << "Translating all coordinates by (-" << _minx << ", -" << _miny << ")" << std::endl;
-  Primitive::set_translation_min_values(_minx, _miny);
-  Surface::set_translation_min_values(_minx, _miny);
+  std::cout << "Translating all coordinates by (-" << ctx.get_translation_x() << ", -" << ctx.get_translation_y() << ")" << std::endl;
 }
 
 
-void read_file_gml(std::string &ifile, std::vector<Feature*>& lsFeatures, IOErrors& errs, double tol_snap, bool geom_is_sem_surfaces)
+void read_file_gml(std::string &ifile, std::vector<Feature*>& lsFeatures, ValidationContext& ctx, bool geom_is_sem_surfaces)
 {
   std::cout << "Reading file: " << ifile << std::endl;
   pugi::xml_document doc;
   if (!doc.load_file(ifile.c_str())) 
   {
-    errs.add_error(901, "Input file not found.");
+    ctx.get_io_errors().add_error(901, "Input file not found.");
     return;
   }
   //-- parse namespace
   pugi::xml_node ncm = doc.first_child();
   std::string vcitygml;
-  get_namespaces(ncm, vcitygml); //-- results in global variable NS in this unit
+  get_namespaces(ncm, ctx, vcitygml);
 
   //-- CityGML v3 is not supported: warning to users
   if (vcitygml == "v3.0") {
-    errs.add_error(904, "CityGML v3.0 files are not supported, use CityJSON (all versions fully supported) or downgrade to v2.0.");
+    ctx.get_io_errors().add_error(904, "CityGML v3.0 files are not supported, use CityJSON (all versions fully supported) or downgrade to v2.0.");
     return;
   }
 
-  if (NS.count("gml") == 0)
+  if (ctx.has_namespace("gml") == false)
   {
-    errs.add_error(901, "Input file does not have the GML namespace.");
+    ctx.get_io_errors().add_error(901, "Input file does not have the GML namespace.");
     return;
   }
-  //-- find (_minx, _miny)
-  compute_min_xy(doc);
+  //-- find the translation (minx, miny)
+  compute_min_xy(doc, ctx);
   //-- build dico of xlinks for <gml:Polygon>
   std::map<std::string, pugi::xpath_node> dallpoly;
-  build_dico_xlinks(doc, dallpoly, errs);
-  if ( (NS.count("citygml") != 0) && (ncm.name() == (NS["citygml"] + "CityModel")) )
+  build_dico_xlinks(doc, dallpoly, ctx);
+  if ( (ctx.has_namespace("citygml") == true) && (ncm.name() == (ctx.ns("citygml") + "CityModel")) )
   {
     std::cout << "CityGML input file" << std::endl;
-    errs.set_input_file_type("CityGML");
-    process_gml_file_city_objects(doc, lsFeatures, dallpoly, errs, tol_snap, geom_is_sem_surfaces);
+    ctx.get_io_errors().set_input_file_type("CityGML");
+    process_gml_file_city_objects(doc, lsFeatures, dallpoly, ctx, geom_is_sem_surfaces);
   }
-  else if ( (NS.count("indoorgml") != 0) && (ncm.name() == (NS["indoorgml"] + "IndoorFeatures")) ) {
+  else if ( (ctx.has_namespace("indoorgml") == true) && (ncm.name() == (ctx.ns("indoorgml") + "IndoorFeatures")) ) {
     std::cout << "IndoorGML input file" << std::endl;
-    errs.set_input_file_type("IndoorGML");
-    process_gml_file_indoorgml(doc, lsFeatures, dallpoly, errs, tol_snap);
+    ctx.get_io_errors().set_input_file_type("IndoorGML");
+    process_gml_file_indoorgml(doc, lsFeatures, dallpoly, ctx);
   }
   else
   {
     std::cout << "GML input file (ie not CityGML)" << std::endl;
-    process_gml_file_primitives(doc, lsFeatures, dallpoly, errs, tol_snap);
+    process_gml_file_primitives(doc, lsFeatures, dallpoly, ctx);
   }
 }
 
 
-void get_namespaces(pugi::xml_node& root, std::string& vcitygml) {
+void get_namespaces(pugi::xml_node& root, ValidationContext& ctx, std::string& vcitygml) {
   vcitygml = "";
   for (pugi::xml_attribute attr = root.first_attribute(); attr; attr = attr.next_attribute()) {
     std::string name = attr.name();
@@ -1266,9 +1520,9 @@ void get_namespaces(pugi::xml_node& root, std::string& vcitygml) {
       if (sns != "") {
         size_t pos = name.find(":");
         if (pos == std::string::npos) 
-          NS[sns] = "";
+          ctx.set_namespace(sns, "");
         else 
-          NS[sns] = name.substr(pos + 1) + ":";
+          ctx.set_namespace(sns, name.substr(pos + 1) + ":");
       }    
     }
   }
@@ -1278,21 +1532,21 @@ void get_namespaces(pugi::xml_node& root, std::string& vcitygml) {
 
 
 
-void build_dico_xlinks(pugi::xml_document& doc, std::map<std::string, pugi::xpath_node>& dallpoly, IOErrors& errs)
+void build_dico_xlinks(pugi::xml_document& doc, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx)
 {
-  std::string s = "//" + NS["gml"] + "Polygon" + "[@" + NS["gml"] + "id]";
+  std::string s = "//" + ctx.ns("gml") + "Polygon" + "[@" + ctx.ns("gml") + "id]";
   pugi::xpath_node_set nallpoly = doc.select_nodes(s.c_str());
   if (nallpoly.size() > 0)
    std::cout << "XLinks found, resolving them..." << std::flush;
   for (pugi::xpath_node_set::const_iterator it = nallpoly.begin(); it != nallpoly.end(); ++it)
     dallpoly[it->node().attribute("gml:id").value()] = *it;
   //-- for <gml:OrientableSurface>
-  s = "//" + NS["gml"] + "OrientableSurface" + "[@" + NS["gml"] + "id" + "]";
+  s = "//" + ctx.ns("gml") + "OrientableSurface" + "[@" + ctx.ns("gml") + "id" + "]";
   pugi::xpath_node_set nallosurf = doc.select_nodes(s.c_str());
   for (pugi::xpath_node_set::const_iterator it = nallosurf.begin(); it != nallosurf.end(); ++it)
     dallpoly[it->node().attribute("gml:id").value()] = *it;
   //-- checking xlinks validity now, not to be bitten later
-  s = "//" + NS["gml"] + "surfaceMember" + "[@" + NS["xlink"] + "href" + "]";
+  s = "//" + ctx.ns("gml") + "surfaceMember" + "[@" + ctx.ns("xlink") + "href" + "]";
   pugi::xpath_node_set nsmxlink = doc.select_nodes(s.c_str());
   for (pugi::xpath_node_set::const_iterator it = nsmxlink.begin(); it != nsmxlink.end(); ++it) 
   {
@@ -1304,7 +1558,7 @@ void build_dico_xlinks(pugi::xml_document& doc, std::map<std::string, pugi::xpat
       std::string r = "One XLink couldn't be resolved (";
       r += it->node().attribute("xlink:href").value();
       r += ")";
-      errs.add_error(901, r);
+      ctx.get_io_errors().add_error(901, r);
       return;
     }
   }
@@ -1313,14 +1567,14 @@ void build_dico_xlinks(pugi::xml_document& doc, std::map<std::string, pugi::xpat
 }
 
 
-Surface* read_file_poly(std::string &ifile, int shellid, IOErrors& errs)
+Surface* read_file_poly(std::string &ifile, int shellid, ValidationContext& ctx)
 {
   std::cout << "Reading file: " << ifile << std::endl;
   std::stringstream st;
   ifstream infile(ifile.c_str(), ifstream::in);
   if (!infile)
   {
-    errs.add_error(901, "Input file not found.");
+    ctx.get_io_errors().add_error(901, "Input file not found.");
     return NULL;
   }
   //-- read the points
@@ -1328,28 +1582,23 @@ Surface* read_file_poly(std::string &ifile, int shellid, IOErrors& errs)
   float tmpfloat;
   double x, y, z;
   infile >> num >> tmpint >> tmpint >> tmpint;
-  //-- compute (_minx, _miny)
+  //-- compute the translation (minx, miny)
   for (int i = 0; i < num; i++)
   {
     infile >> tmpint >> x >> y >> z;
-    if (x < _minx)
-      _minx = x;
-    if (y < _miny)
-      _miny = y;
+    ctx.update_translation(x, y);
   }
-  std::cout << "Translating all coordinates by (-" << _minx << ", -" << _miny << ")" << std::endl;
-  Primitive::set_translation_min_values(_minx, _miny);
-  Surface::set_translation_min_values(_minx, _miny);
+  std::cout << "Translating all coordinates by (-" << ctx.get_translation_x() << ", -" << ctx.get_translation_y() << ")" << std::endl;
   infile.close();
   infile.open(ifile.c_str(), std::ifstream::in);
   infile >> num >> tmpint >> tmpint >> tmpint;
   //-- read verticess
-  Surface* sh = new Surface(shellid);  
+  Surface* sh = new Surface(ctx, shellid, false);  
   for (int i = 0; i < num; i++)
   {
     infile >> tmpint >> x >> y >> z;
-    x -= _minx;
-    y -= _miny;
+    x -= ctx.get_translation_x();
+    y -= ctx.get_translation_y();
     Point3 p(x, y, z);
     sh->add_point(p);
   }
@@ -1419,14 +1668,14 @@ void printProgressBar(int percent) {
   std::cout << percent << "%     " << std::flush;
 }
 
-Surface* read_file_off(std::string &ifile, int shellid, IOErrors& errs)
+Surface* read_file_off(std::string &ifile, int shellid, ValidationContext& ctx)
 {
   std::cout << "Reading file: " << ifile << std::endl;
   std::stringstream st;
   ifstream infile(ifile.c_str(), ifstream::in);
   if (!infile)
   {
-    errs.add_error(901, "Input file not found.");
+    ctx.get_io_errors().add_error(901, "Input file not found.");
     return NULL;
   }
   //-- read the points
@@ -1435,35 +1684,30 @@ Surface* read_file_off(std::string &ifile, int shellid, IOErrors& errs)
   infile >> s;
   infile >> numpt >> numf >> tmpint;
   if ( (s != "OFF") || (numpt <= 0) ) {
-    errs.add_error(901, "Input file not a valid OFF file.");
+    ctx.get_io_errors().add_error(901, "Input file not a valid OFF file.");
     return NULL;
   }
-  //-- compute (_minx, _miny)
+  //-- compute the translation (minx, miny)
   for (int i = 0; i < numpt; i++)
   {
     double x, y, z;
     infile >> x >> y >> z;
-    if (x < _minx)
-      _minx = x;
-    if (y < _miny)
-      _miny = y;
+    ctx.update_translation(x, y);
   }
-  std::cout << "Translating all coordinates by (-" << _minx << ", -" << _miny << ")" << std::endl;
-  Primitive::set_translation_min_values(_minx, _miny);
-  Surface::set_translation_min_values(_minx, _miny);
+  std::cout << "Translating all coordinates by (-" << ctx.get_translation_x() << ", -" << ctx.get_translation_y() << ")" << std::endl;
   //-- reset the file
   infile.close();
   infile.open(ifile.c_str(), std::ifstream::in);
   infile >> s;
   infile >> numpt >> numf >> tmpint;
   //-- read the points
-  Surface* sh = new Surface(shellid);  
+  Surface* sh = new Surface(ctx, shellid, false);  
   for (int i = 0; i < numpt; i++)
   {
     double x, y, z;
     infile >> x >> y >> z;
-    x -= _minx;
-    y -= _miny;
+    x -= ctx.get_translation_x();
+    y -= ctx.get_translation_y();
     Point3 p(x, y, z);
     sh->add_point(p);
   }
@@ -1474,7 +1718,7 @@ Surface* read_file_off(std::string &ifile, int shellid, IOErrors& errs)
     std::vector<int> ids(tmpint);
     if (ids.empty() == true)
     {
-      errs.add_error(901, "Some surfaces not defined correctly or are empty");
+      ctx.get_io_errors().add_error(901, "Some surfaces not defined correctly or are empty");
       return NULL;
     }
     for (int k = 0; k < tmpint; k++)
@@ -1487,13 +1731,13 @@ Surface* read_file_off(std::string &ifile, int shellid, IOErrors& errs)
 }
 
 
-void read_file_obj(std::vector<Feature*>& lsFeatures, std::string &ifile, Primitive3D prim3d, IOErrors& errs, double tol_snap)
+void read_file_obj(std::vector<Feature*>& lsFeatures, std::string &ifile, Primitive3D prim3d, ValidationContext& ctx)
 {
   std::cout << "Reading file: " << ifile << std::endl;
   std::ifstream infile(ifile.c_str(), std::ifstream::in);
   if (!infile)
   {
-    errs.add_error(901, "Input file not found.");
+    ctx.get_io_errors().add_error(901, "Input file not found.");
     return;
   }
   //-- find (minx, miny)
@@ -1505,20 +1749,15 @@ void read_file_obj(std::vector<Feature*>& lsFeatures, std::string &ifile, Primit
       std::string tmp;
       double x, y, z;
       iss >> tmp >> x >> y >> z;
-      if (x < _minx)
-        _minx = x;
-      if (y < _miny)
-        _miny = y;
+      ctx.update_translation(x, y);
     }
   }
-  std::cout << "Translating all coordinates by (-" << _minx << ", -" << _miny << ")" << std::endl;
-  Primitive::set_translation_min_values(_minx, _miny);
-  Surface::set_translation_min_values(_minx, _miny);
+  std::cout << "Translating all coordinates by (-" << ctx.get_translation_x() << ", -" << ctx.get_translation_y() << ")" << std::endl;
   //-- read again file and parse everything
   infile.close();
   infile.open(ifile.c_str(), std::ifstream::in);
   int primid = 0;
-  Surface* sh = new Surface(0, tol_snap);
+  Surface* sh = new Surface(ctx, 0);
   std::vector<Point3*> allvertices;
   GenericObject* o = new GenericObject("none");
   while (std::getline(infile, l)) {
@@ -1527,8 +1766,8 @@ void read_file_obj(std::vector<Feature*>& lsFeatures, std::string &ifile, Primit
       std::string tmp;
       double x, y, z;
       iss >> tmp >> x >> y >> z;
-      x -= _minx;
-      y -= _miny;
+      x -= ctx.get_translation_x();
+      y -= ctx.get_translation_y();
       Point3 *p = new Point3(x, y, z);
       allvertices.push_back(p);
     }
@@ -1554,10 +1793,10 @@ void read_file_obj(std::vector<Feature*>& lsFeatures, std::string &ifile, Primit
           o->add_primitive(ms);
         }
         primid++;
-        sh = new Surface(0, tol_snap);
+        sh = new Surface(ctx, 0);
       }
       // else {
-      //   errs.add_error(901, "Some surfaces not defined correctly or are empty");
+      //   ctx.get_io_errors().add_error(901, "Some surfaces not defined correctly or are empty");
       //   return;
       // }
     }
@@ -1586,7 +1825,7 @@ void read_file_obj(std::vector<Feature*>& lsFeatures, std::string &ifile, Primit
     }
   }
   if (sh->is_empty() == true) {
-    errs.add_error(902, "Some surfaces not defined correctly or are empty");
+    ctx.get_io_errors().add_error(902, "Some surfaces not defined correctly or are empty");
     return;
   }
   if (prim3d == SOLID)
@@ -33,6 +33,7 @@
 #include "definitions.h"
 #include <fstream>
 #include <string>
+#include <functional>
 #include "pugixml/pugixml.hpp"
 #include "nlohmann-json/json.hpp"
 
@@ -53,6 +54,7 @@ namespace val3dity
   class CompositeSolid;
   class MultiSolid;
   class GeometryTemplate;
+  class ValidationContext;
 
 
 class IOErrors {
@@ -157,45 +159,51 @@ struct semantic_surfaces_walker: pugi::xml_tree_walker {
 
 //--
 
-void              read_file_gml(std::string &ifile, std::vector<Feature*>& lsFeatures, IOErrors& errs, double tol_snap, bool geom_is_sem_surfaces);
-void              get_namespaces(pugi::xml_node& root, std::string& vcitygml);
+void              read_file_gml(std::string &ifile, std::vector<Feature*>& lsFeatures, ValidationContext& ctx, bool geom_is_sem_surfaces);
+void              get_namespaces(pugi::xml_node& root, ValidationContext& ctx, std::string& vcitygml);
 
-void              read_file_cityjson(std::string &ifile, std::vector<Feature*>& lsFeatures, IOErrors& errs, double tol_snap);
+void              read_file_cityjson(std::string &ifile, std::vector<Feature*>& lsFeatures, ValidationContext& ctx);
+json::parser_callback_t track_depth(std::function<bool(int, json::parse_event_t, json&)> f);
+void              read_file_cityjson_stream(std::string &ifile, ValidationContext& ctx, std::vector<GeometryTemplate*>& lsGTs, std::function<void(CityObject*)> process);
+void              read_file_cityjsonseq(std::string &ifile, ValidationContext& ctx, std::vector<GeometryTemplate*>& lsGTs, std::function<void(CityObject*)> process);
 
 void              print_information(std::string &ifile);
-void              report_primitives(pugi::xml_document& doc);
-void              report_building(pugi::xml_document& doc);
-void              report_building_each_lod(pugi::xml_document& doc, int lod, int& total_solid, int& total_ms, int& total_sem);
+void              report_primitives(pugi::xml_document& doc, ValidationContext& ctx);
+void              report_building(pugi::xml_document& doc, ValidationContext& ctx);
+void              report_building_each_lod(pugi::xml_document& doc, ValidationContext& ctx, int lod, int& total_solid, int& total_ms, int& total_sem);
 void              print_info_aligned(std::string o, size_t number, bool tab = false);
 
-void              read_file_obj(std::vector<Feature*>& lsFeatures, std::string &ifile, Primitive3D prim3d, IOErrors& errs, double tol_snap);
-Surface*          read_file_poly(std::string &ifile, int shellid, IOErrors& errs);
-Surface*          read_file_off(std::string &ifile, int shellid, IOErrors& errs);
-
-std::vector<int>  process_gml_ring(const pugi::xml_node& n, Surface* sh, IOErrors& errs);
-Surface*          process_gml_surface(const pugi::xml_node& n, int id, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs);
-MultiSurface*     process_gml_multisurface(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs);
-CompositeSurface* process_gml_compositesurface(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs);
-Solid*            process_gml_solid(const pugi::xml_node& nsolid, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs);
-MultiSolid*       process_gml_multisolid(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs);
-CompositeSolid*   process_gml_compositesolid(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, double tol_snap, IOErrors& errs);
-
-
-void              process_json_geometries_of_co(json& jco, CityObject* co, std::vector<GeometryTemplate*>& lsGTs, json& j, double tol_snap);
-void              process_json_surface(std::vector< std::vector<int> >& pgn, nlohmann::json& j, Surface* s);
-void              process_cityjson_geometrytemplates(json& jgt, std::vector<GeometryTemplate*>& lsGTs, double tol_snap);
-void              process_json_surface_geometrytemplate(std::vector< std::vector<int> >& pgn, json& j, Surface* sh);
-void              build_dico_xlinks(pugi::xml_document& doc, std::map<std::string, pugi::xpath_node>& dallpoly, IOErrors& errs);
-void              process_gml_file_city_objects(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, IOErrors& errs, double tol_snap, bool geom_is_sem_surfaces);
-void              process_gml_file_primitives(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, IOErrors& errs, double tol_snap);
-void              process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, IOErrors& errs, double tol_snap);
+void              read_file_obj(std::vector<Feature*>& lsFeatures, std::string &ifile, Primitive3D prim3d, ValidationContext& ctx);
+Surface*          read_file_poly(std::string &ifile, int shellid, ValidationContext& ctx);
+Surface*          read_file_off(std::string &ifile, int shellid, ValidationContext& ctx);
+
+std::vector<int>  process_gml_ring(const pugi::xml_node& n, Surface* sh, ValidationContext& ctx);
+Surface*          process_gml_surface(const pugi::xml_node& n, int id, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx);
+MultiSurface*     process_gml_multisurface(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx);
+CompositeSurface* process_gml_compositesurface(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx);
+Solid*            process_gml_solid(const pugi::xml_node& nsolid, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx);
+MultiSolid*       process_gml_multisolid(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx);
+CompositeSolid*   process_gml_compositesolid(const pugi::xml_node& nms, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx);
+
+
+void              process_cityjson_cityobjects(json& jcos, std::vector<GeometryTemplate*>& lsGTs, const std::vector<double>& vertices, ValidationContext& ctx, std::function<void(CityObject*)> process);
+void              process_json_geometries_of_co(json& jco, CityObject* co, std::vector<GeometryTemplate*>& lsGTs, const std::vector<double>& vertices, ValidationContext& ctx);
+void              process_json_surface(const json& pgn, const std::vector<double>& vertices, Surface* s, ValidationContext& ctx);
+void              process_cityjson_geometrytemplates(json& jgt, std::vector<GeometryTemplate*>& lsGTs, ValidationContext& ctx);
+void              process_json_surface_geometrytemplate(const json& pgn, json& j, Surface* sh);
+void              build_dico_xlinks(pugi::xml_document& doc, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx);
+void              process_gml_file_city_objects(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx, bool geom_is_sem_surfaces);
+void              process_gml_file_primitives(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx);
+void              process_gml_file_indoorgml(pugi::xml_document& doc, std::vector<Feature*>& lsFeatures, std::map<std::string, pugi::xpath_node>& dallpoly, ValidationContext& ctx);
 
 void              printProgressBar(int percent);
 std::string       localise(std::string s);
 std::string       remove_xml_namespace(const char* input);
 
-void              compute_min_xy(pugi::xml_document& doc);
-void              compute_min_xy(json& j);
+void              compute_min_xy(pugi::xml_document& doc, ValidationContext& ctx);
+void              compute_min_xy(const std::vector<double>& vertices, ValidationContext& ctx);
+void              decode_cityjson_vertices(json& j, std::vector<double>& vertices, ValidationContext& ctx);
+void              transform_cityjson_vertices(json& j, std::vector<double>& vertices, ValidationContext& ctx, bool update_translation = true);
 
 } // namespace val3dity
 
@@ -35,10 +35,20 @@
 #include "Feature.h"
 #include "CityObject.h"
 #include "GenericObject.h"
+#include "GeometryTemplate.h"
+#include "ValidatedFeature.h"
 #include "validate_prim_toporel.h"
+#include "parallel.h"
+#include "allocations.h"
+#include "ValidationContext.h"
 
 #include <tclap/CmdLine.h>
 #include <time.h>  
+#include <mutex>
+#include <future>
+#include <condition_variable>
+#include <memory>
+#include <algorithm>
 #include "nlohmann-json/json.hpp"
 #include <boost/filesystem.hpp>
 
@@ -60,6 +70,30 @@ void        get_report_json(json& jr,
                             double planarity_d2p_tol, 
                             double planarity_n_tol, 
                             IOErrors ioerrs);
+InputTypes  get_input_type(std::string ifile, IOErrors& ioerrs);
+Primitive3D get_primitive_type(InputTypes inputtype, std::string primitives);
+bool        get_batch_inputs(std::string input, std::vector<std::string>& lsInputs);
+void        read_input(std::string ifile, 
+                       InputTypes inputtype, 
+                       Primitive3D prim3d, 
+                       const std::vector<std::string>& ishellfiles, 
+                       bool geom_is_sem_surfaces, 
+                       std::vector<Feature*>& lsFeatures, 
+                       ValidationContext& ctx);
+void        print_parameters(Primitive3D prim3d, const ValidationContext& ctx);
+void        validate_features(std::vector<Feature*>& lsFeatures, const ValidationContext& ctx, bool verbose);
+void        validate_cityjson_stream(std::string ifile, InputTypes inputtype, std::vector<Feature*>& lsFeatures, ValidationContext& ctx, bool verbose);
+void        write_off_files(std::vector<Feature*>& lsFeatures, std::string output_off);
+void        delete_features(std::vector<Feature*>& lsFeatures);
+void        validate_batch(const std::vector<std::string>& lsInputs, 
+                           const ValidationContext& params, 
+                           std::string primitives, 
+                           bool geom_is_sem_surfaces, 
+                           std::string report, 
+                           std::string output_off, 
+                           bool unittests, 
+                           bool verbose);
+std::string print_summary_batch(json& js);
 
 
 class MyOutput : public TCLAP::StdOutput
@@ -106,6 +140,13 @@ public:
     
     std::cout << "\tval3dity input.gml --snap_tol 0.1" << std::endl;
     std::cout << "\t\tThe vertices in input.gml closer than 0.1unit are snapped together" << std::endl;
+
+    std::cout << "\tval3dity input.json --threads 8" << std::endl;
+    std::cout << "\t\tThe features in input.json are validated with 8 threads" << std::endl;
+
+    std::cout << "\tval3dity mydata/ --report /home/elvis/temp/reports" << std::endl;
+    std::cout << "\t\tValidate each file in the directory mydata (a glob like 'mydata/*.json' or a list file" << std::endl;
+    std::cout << "\t\tlike files.txt can also be used); one report per file and a summary are saved in reports/" << std::endl;
   }
 
   virtual void failure(TCLAP::CmdLineInterface& c, TCLAP::ArgException& e)
@@ -174,7 +215,8 @@ class ListErrorsPrint : public TCLAP::Visitor
 
 int main(int argc, char* const argv[])
 {
-  IOErrors ioerrs;
+  ValidationContext ctx;
+  IOErrors& ioerrs = ctx.get_io_errors();
   std::streambuf* savedBufferCLOG;
   std::ofstream mylog;
 
@@ -184,6 +226,10 @@ int main(int argc, char* const argv[])
   primitivestovalidate.push_back("CompositeSurface");   
   primitivestovalidate.push_back("MultiSurface");   
   TCLAP::ValuesConstraint<std::string> primVals(primitivestovalidate);
+  std::vector<std::string> polygonengines;
+  polygonengines.push_back("geos");  
+  polygonengines.push_back("native");   
+  TCLAP::ValuesConstraint<std::string> engineVals(polygonengines);
 
   TCLAP::CmdLine cmd("Allowed options", ' ', VAL3DITY_VERSION);
   MyOutput my;
@@ -191,7 +237,7 @@ int main(int argc, char* const argv[])
   try {
     TCLAP::UnlabeledValueArg<std::string>   inputfile(
                                               "inputfile", 
-                                              "input file in either GML, CityJSON, OBJ, or OFF",
+                                              "input file in either GML, CityJSON, CityJSONSeq, OBJ, or OFF; or a directory, a glob, or a list file (.txt) for a batch",
                                               true, 
                                               "", 
                                               "string");
@@ -245,6 +291,10 @@ int main(int argc, char* const argv[])
                                               false,
                                               "",
                                               "string");        
+    TCLAP::SwitchArg                        stream("",
+                                              "stream",
+                                              "CityJSON only: stream the file, City Objects are freed once validated",
+                                              false);
     TCLAP::ValueArg<double>                 snap_tol("",
                                               "snap_tol",
                                               "tolerance for snapping vertices in GML (default=0.001)",
@@ -269,17 +319,44 @@ int main(int argc, char* const argv[])
                                               false,
                                               20.0,
                                               "double");
+    TCLAP::ValueArg<std::string>            polygon_engine("",
+                                              "polygon_engine",
+                                              "engine to validate the polygons: GEOS or native, without GEOS (default=geos)",
+                                              false,
+                                              "geos",
+                                              &engineVals);
+    TCLAP::ValueArg<int>                    threads("",
+                                              "threads",
+                                              "number of threads used to validate the features, 0 to use all the cores (default=1)",
+                                              false,
+                                              1,
+                                              "int");
+    TCLAP::ValueArg<int>                    min_triangles_parallel("",
+                                              "min_triangles_parallel",
+                                              "with threads, surfaces with more triangles are tested for self-intersections in parallel (default=50000)",
+                                              false,
+                                              50000,
+                                              "int");
+    TCLAP::SwitchArg                        auto_orient("",
+                                              "auto_orient",
+                                              "reorient the faces of the shells consistently before validating them (error 307 is then not reported)",
+                                              false);
 
     cmd.add(planarity_d2p_tol);
     cmd.add(planarity_n_tol);
     cmd.add(snap_tol);
     cmd.add(overlap_tol);
+    cmd.add(threads);
+    cmd.add(min_triangles_parallel);
+    cmd.add(polygon_engine);
+    cmd.add(auto_orient);
     cmd.add(verbose);
     cmd.add(primitives);
     cmd.add(geom_is_sem_surfaces);
     cmd.add(ignore204);
     cmd.add(unittests);
     cmd.add(output_off);
+    cmd.add(stream);
     cmd.add(inputfile);
     cmd.add(listerrors);
     cmd.add(license);
@@ -287,33 +364,6 @@ int main(int argc, char* const argv[])
     cmd.add(report);
     cmd.parse( argc, argv );
 
-    //-- vector with Features: CityObject, GenericObject, 
-    //-- or IndoorModel (or others in the future)
-    std::vector<Feature*> lsFeatures;
-    
-    InputTypes inputtype = OTHER;
-    std::string extension = inputfile.getValue().substr(inputfile.getValue().find_last_of(".") + 1);
-    if ( (extension == "gml") || (extension == "GML") || (extension == "xml") || (extension == "XML") ) {
-      inputtype = GML;
-      ioerrs.set_input_file_type("GML");
-    }
-    else if ( (extension == "poly") || (extension == "POLY") ) {
-      inputtype = POLY;    
-      ioerrs.set_input_file_type("POLY");
-    }
-    else if ( (extension == "json") || (extension == "JSON") ) {
-      inputtype = JSON;
-      ioerrs.set_input_file_type("CityJSON");
-    }
-    else if ( (extension == "obj") || (extension == "OBJ") ) {
-      inputtype = OBJ;
-      ioerrs.set_input_file_type("OBJ");
-    }
-    else if ( (extension == "off") || (extension == "OFF") ) {
-      inputtype = OFF;
-      ioerrs.set_input_file_type("OFF");
-    }
-
     //-- if verbose == false then log to a file
     if (verbose.getValue() == false)
     {
@@ -322,13 +372,76 @@ int main(int argc, char* const argv[])
       std::clog.rdbuf(mylog.rdbuf());
     }
 
+    std::string licensewarning =
+    "---\nval3dity Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft  \n"
+    "This program comes with ABSOLUTELY NO WARRANTY.\n"
+    "This is free software, and you are welcome to redistribute it\n"
+    "under certain conditions; for details run val3dity with the '--license' option.\n---";
+
+    double planarity_n_tol_updated = planarity_n_tol.getValue();
+    if (ignore204.getValue() == true)
+      planarity_n_tol_updated = 180.0;
+    PolygonEngine engine = (polygon_engine.getValue() == "native") ? ENGINE_NATIVE : ENGINE_GEOS;
+
+    //-- a directory, a glob or a list file: validate each of the files
+    std::vector<std::string> lsInputs;
+    if (get_batch_inputs(inputfile.getValue(), lsInputs) == true)
+    {
+      std::cout << licensewarning << std::endl;
+      if ( (snap_tol.getValue() < 0) || (threads.getValue() < 0) || (ishellfiles.getValue().size() > 0) )
+      {
+        std::cout << "ERROR: in batch mode snap_tol and threads cannot be negative, and ishell cannot be used." << std::endl;
+        if (verbose.getValue() == false)
+          clog.rdbuf(savedBufferCLOG);
+        return(1);
+      }
+      ValidationContext params(snap_tol.getValue(),
+                               planarity_d2p_tol.getValue(),
+                               planarity_n_tol_updated,
+                               overlap_tol.getValue());
+      params.set_polygon_engine(engine);
+      params.set_min_triangles_parallel(min_triangles_parallel.getValue());
+      params.set_auto_orient(auto_orient.getValue());
+      int nthreads = get_number_threads(threads.getValue());
+      if (nthreads > 1)
+        TaskScheduler::start(nthreads);
+      validate_batch(lsInputs,
+                     params,
+                     primitives.getValue(),
+                     geom_is_sem_surfaces.getValue(),
+                     report.getValue(),
+                     output_off.getValue(),
+                     unittests.getValue(),
+                     verbose.getValue());
+      if (nthreads > 1)
+        TaskScheduler::stop();
+      if (verbose.getValue() == false)
+      {
+        clog.rdbuf(savedBufferCLOG);
+        mylog.close();
+      }
+      return(0);
+    }
+
+    //-- vector with Features: CityObject, GenericObject,
+    //-- or IndoorModel (or others in the future)
+    std::vector<Feature*> lsFeatures;
+
+    InputTypes inputtype = get_input_type(inputfile.getValue(), ioerrs);
+
     //-- no negative snap_tol value
-    if (snap_tol.getValue() < 0) 
+    if (snap_tol.getValue() < 0)
     {
       ioerrs.add_error(903, "snap_tol cannot be negative");
     }
 
-    
+    //-- no negative number of threads
+    if (threads.getValue() < 0)
+    {
+      ioerrs.add_error(903, "threads cannot be negative");
+    }
+
+
     if (inputtype == OTHER) {
       std::stringstream ss;
       ss << "Format of file " << inputfile.getValue() << " not supported (based on its extension).";
@@ -336,201 +449,61 @@ int main(int argc, char* const argv[])
       ioerrs.set_input_file_type("UNKNOWN");
     }
 
-    Primitive3D prim3d;
-    if ( (inputtype == JSON) || (inputtype == GML) )
-    {
-      prim3d = ALL;
-    }
-    else {
-      if (primitives.getValue() == "Solid")
-        prim3d = SOLID;
-      else if (primitives.getValue() == "MultiSurface")
-        prim3d = MULTISURFACE;
-      else if (primitives.getValue() == "CompositeSurface")
-        prim3d = COMPOSITESURFACE;
-      if ((prim3d == COMPOSITESURFACE) && (ishellfiles.getValue().size() > 0))
-        ioerrs.add_error(903, "POLY files having inner shells cannot be validated as CompositeSurface (only Solids)");
-    }
+    Primitive3D prim3d = get_primitive_type(inputtype, primitives.getValue());
+    if ((prim3d == COMPOSITESURFACE) && (ishellfiles.getValue().size() > 0))
+      ioerrs.add_error(903, "POLY files having inner shells cannot be validated as CompositeSurface (only Solids)");
 
-    std::string licensewarning =
-    "---\nval3dity Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft  \n"
-    "This program comes with ABSOLUTELY NO WARRANTY.\n"
-    "This is free software, and you are welcome to redistribute it\n"
-    "under certain conditions; for details run val3dity with the '--license' option.\n---";
     std::cout << licensewarning << std::endl;
 
 
-    if (ioerrs.has_errors() == false)
-    {
-      if (inputtype == GML)
-      {
-        try
-        {
-          read_file_gml(inputfile.getValue(), 
-                        lsFeatures,
-                        ioerrs, 
-                        snap_tol.getValue(),
-                        geom_is_sem_surfaces.getValue());
-          if (ioerrs.has_errors() == true) {
-            std::cout << "Errors while reading the input file, aborting." << std::endl;
-            std::cout << ioerrs.get_report_text() << std::endl;
-          }
-          if (ishellfiles.getValue().size() > 0)
-          {
-            std::cout << "No inner shells allowed when GML file used as input." << std::endl;
-            ioerrs.add_error(901, "No inner shells allowed when GML file used as input.");
-          }
-        }
-        catch (int e)
-        {
-          if (e == 901)
-            ioerrs.add_error(901, "Invalid GML structure, or that particular construction of GML is not supported yet. Please report at https://github.com/tudelft3d/val3dity/issues and provide the file.");
-        }
-      }
-      else if (inputtype == JSON)
-      {
-        read_file_cityjson(inputfile.getValue(), 
-                           lsFeatures,
-                           ioerrs, 
-                           snap_tol.getValue());
-        if (ioerrs.has_errors() == true) {
-          std::cout << "Errors while reading the input file, aborting." << std::endl;
-          std::cout << ioerrs.get_report_text() << std::endl;
-        }
-        if (ishellfiles.getValue().size() > 0)
-        {
-          std::cout << "No inner shells allowed when GML file used as input." << std::endl;
-          ioerrs.add_error(901, "No inner shells allowed when GML file used as input.");
-        }
-      }
-      else if (inputtype == POLY)
-      {
-        GenericObject* o = new GenericObject("none");
-        Surface* sh = read_file_poly(inputfile.getValue(), 0, ioerrs);
-        if ( (ioerrs.has_errors() == false) & (prim3d == SOLID) )
-        {
-          Solid* s = new Solid;
-          s->set_oshell(sh);
-          int sid = 1;
-          for (auto ifile : ishellfiles.getValue())
-          {
-            Surface* sh = read_file_poly(ifile, sid, ioerrs);
-            if (ioerrs.has_errors() == false)
-            {
-              s->add_ishell(sh);
-              sid++;
-            }
-          }
-          if (ioerrs.has_errors() == false)
-            o->add_primitive(s);
-        }
-        else if ( (ioerrs.has_errors() == false) & (prim3d == COMPOSITESURFACE) )
-        {
-          CompositeSurface* cs = new CompositeSurface;
-          cs->set_surface(sh);
-          if (ioerrs.has_errors() == false)
-            o->add_primitive(cs);
-        }
-        else if ( (ioerrs.has_errors() == false) & (prim3d == MULTISURFACE) )
-        {
-          MultiSurface* ms = new MultiSurface;
-          ms->set_surface(sh);
-          if (ioerrs.has_errors() == false)
-            o->add_primitive(ms);
-        }
-        lsFeatures.push_back(o);      
-      }
-      else if (inputtype == OFF)
-      {
-        GenericObject* o = new GenericObject("none");
-        Surface* sh = read_file_off(inputfile.getValue(), 0, ioerrs);
-        if ( (ioerrs.has_errors() == false) & (prim3d == SOLID) )
-        {
-          Solid* s = new Solid;
-          s->set_oshell(sh);
-          if (ioerrs.has_errors() == false)
-            o->add_primitive(s);
-        }
-        else if ( (ioerrs.has_errors() == false) & (prim3d == COMPOSITESURFACE) )
-        {
-          CompositeSurface* cs = new CompositeSurface;
-          cs->set_surface(sh);
-          if (ioerrs.has_errors() == false)
-            o->add_primitive(cs);
-        }
-        else if ( (ioerrs.has_errors() == false) & (prim3d == MULTISURFACE) )
-        {
-          MultiSurface* ms = new MultiSurface;
-          ms->set_surface(sh);
-          if (ioerrs.has_errors() == false)
-            o->add_primitive(ms);
-        }
-        lsFeatures.push_back(o);
-      }    
-      else if (inputtype == OBJ)
-      {
-        read_file_obj(lsFeatures,
-                      inputfile.getValue(), 
-                      prim3d,
-                      ioerrs, 
-                      snap_tol.getValue());
-        if (ioerrs.has_errors() == true) {
-          std::cout << "Errors while reading the input file, aborting." << std::endl;
-          std::cout << ioerrs.get_report_text() << std::endl;
-        }
-        if (ishellfiles.getValue().size() > 0)
-        {
-          std::cout << "No inner shells allowed when GML file used as input." << std::endl;
-          ioerrs.add_error(901, "No inner shells allowed when GML file used as input.");
-        }
-      }
-    }
+    ctx.set_tol_snap(snap_tol.getValue());
+    ctx.set_tol_planarity_d2p(planarity_d2p_tol.getValue());
+    ctx.set_tol_planarity_normals(planarity_n_tol_updated);
+    ctx.set_tol_overlap(overlap_tol.getValue());
+    ctx.set_polygon_engine(engine);
+    ctx.set_min_triangles_parallel(min_triangles_parallel.getValue());
+    ctx.set_auto_orient(auto_orient.getValue());
+    //-- a CityJSONSeq file is always streamed
+    bool streamed = ( (stream.getValue() == true) || (inputtype == JSONL) );
+    if ( (stream.getValue() == true) && (inputtype != JSON) && (inputtype != JSONL) )
+      ioerrs.add_error(903, "only CityJSON files can be streamed");
+    if ( (streamed == true) && (output_off.getValue() != "") )
+      ioerrs.add_error(903, "output_off cannot be used when the file is streamed");
 
-    double planarity_n_tol_updated = planarity_n_tol.getValue();
-    if (ioerrs.has_errors() == false) 
-    {
-      std::cout << "Primitive(s) validated: ";
-      if (prim3d == SOLID)        
-        std::cout << "Solid" << std::endl;
-      else if (prim3d == MULTISURFACE)        
-        std::cout << "MultiSurface" << std::endl;
-      else if (prim3d == COMPOSITESURFACE)        
-        std::cout << "CompositeSurface" << std::endl;
-      else {
-        std::cout << "All" << std::endl;
-        std::cout << "(CityGML/CityJSON/IndoorGML have all their 3D primitives validated)" << std::endl;
-      }
-      //-- report on parameters used
-      if (ignore204.getValue() == true)
-        planarity_n_tol_updated = 180.0;
-      std::cout << "Parameters used for validation:" << std::endl;
-      if (snap_tol.getValue() < 0)
-        std::cout << "   snap_tol"    << setw(22)  << "0.001" << std::endl;
-      else
-        std::cout << "   snap_tol"    << setw(22)  << snap_tol.getValue() << std::endl;
-      std::cout << "   planarity_d2p_tol"     << setw(13)  << planarity_d2p_tol.getValue() << std::endl;
-      std::cout << "   planarity_n_tol"       << setw(15) << planarity_n_tol_updated << std::endl;
-      if (overlap_tol.getValue() < 1e-8)
-        std::cout << "   overlap_tol" << setw(19)  << "none" << std::endl;
-      else
-        std::cout << "   overlap_tol" << setw(19)  << overlap_tol.getValue() << std::endl;
-      std::cout << std::endl;
+    //-- streamed: each City Object is validated as soon as it is read
+    if ( (streamed == true) && (ioerrs.has_errors() == false) )
+    {
+      print_parameters(prim3d, ctx);
+      int nthreads = get_number_threads(threads.getValue());
+      if (nthreads > 1)
+        TaskScheduler::start(nthreads);
+      validate_cityjson_stream(inputfile.getValue(), inputtype, lsFeatures, ctx, verbose.getValue());
+      if (nthreads > 1)
+        TaskScheduler::stop();
     }
-    
-    //-- now the validation starts
-    if ( (lsFeatures.empty() == false) && (ioerrs.has_errors() == false) )
+    else 
     {
-      int i = 1;
-      std::cout << "Validation of " << lsFeatures.size() << " feature(s):" << std::endl;
-      for (auto& f : lsFeatures)
+      if (ioerrs.has_errors() == false)
+        read_input(inputfile.getValue(),
+                   inputtype,
+                   prim3d,
+                   ishellfiles.getValue(),
+                   geom_is_sem_surfaces.getValue(),
+                   lsFeatures,
+                   ctx);
+      if (ioerrs.has_errors() == false)
+        print_parameters(prim3d, ctx);
+      //-- now the validation starts
+      if ( (lsFeatures.empty() == false) && (ioerrs.has_errors() == false) )
       {
-        if ( (i % 10 == 0) && (verbose.getValue() == false) )
-          printProgressBar(100 * (i / double(lsFeatures.size())));
-        i++;
-        f->validate(planarity_d2p_tol.getValue(), planarity_n_tol_updated, overlap_tol.getValue());
+        int nthreads = get_number_threads(threads.getValue());
+        if (nthreads > 1)
+          TaskScheduler::start(nthreads);
+        std::cout << "Validation of " << lsFeatures.size() << " feature(s):" << std::endl;
+        validate_features(lsFeatures, ctx, verbose.getValue());
+        if (nthreads > 1)
+          TaskScheduler::stop();
       }
-      if (verbose.getValue() == false)
-        printProgressBar(100);
     }
 
     //-- if error 901 then ignore what was read, it can't be validated
@@ -541,70 +514,18 @@ int main(int argc, char* const argv[])
     }
 
     //-- summary of the validation
-    std::cout << "\n" << print_summary_validation(lsFeatures, ioerrs) << std::endl;        
+    std::cout << "\n" << print_summary_validation(lsFeatures, ioerrs) << std::endl;
 
     //-- output shells/surfaces in OFF format
-    if (output_off.getValue() != "") 
-    {
-      std::cout << std::endl << std::endl;
-      boost::filesystem::path outpath(output_off.getValue());
-      if (boost::filesystem::exists(outpath.parent_path()) == false)
-        std::cout << "Error OFF output: file " << outpath << " impossible to create, wrong path." << std::endl;
-      else {
-        if (boost::filesystem::exists(outpath) == false)
-          boost::filesystem::create_directory(outpath);
-        std::cout << "OFF files saved to: " << outpath << std::endl;
-        for (auto& f : lsFeatures) {
-          int noprim = 0;
-          for (auto& p : f->get_primitives()) {
-            std::string theid = f->get_id() + "." + std::to_string(noprim);
-            if (p->get_type() == SOLID)
-            {
-              boost::filesystem::path outfile = outpath / (theid + ".0.off");
-              std::ofstream o(outfile.string());
-              Solid* ts = dynamic_cast<Solid*>(p);
-              o << ts->get_off_representation(0) << std::endl;                                
-              o.close();
-              for (int i = 1; i <= ts->num_ishells(); i++)
-              {
-                outfile = outpath / (theid + "." + std::to_string(i) + ".off");
-                o.open(outfile.string());
-                o << ts->get_off_representation(1) << std::endl;                                
-                o.close();
-              }
-            }
-            else if (p->get_type() == MULTISURFACE)
-            {
-              boost::filesystem::path outfile = outpath / (theid + ".off");
-              std::ofstream o(outfile.string());
-              MultiSurface* ts = dynamic_cast<MultiSurface*>(p);
-              o << ts->get_off_representation() << std::endl;                                
-              o.close();
-            }
-            else if (p->get_type() == COMPOSITESURFACE)
-            {
-              boost::filesystem::path outfile = outpath / (theid + ".off");
-              std::ofstream o(outfile.string());
-              CompositeSurface* ts = dynamic_cast<CompositeSurface*>(p);
-              o << ts->get_off_representation() << std::endl;                                
-              o.close();
-            }            
-            else {
-              std::cout << "OFF OUTPUT: these primitive types are not supported (yet). Sorry." << std::endl;
-            }
-            noprim++;
-          }
-        }
-      }
-      std::cout << std::endl;
-    }
+    if (output_off.getValue() != "")
+      write_off_files(lsFeatures, output_off.getValue());
 
-    //-- output report in JSON 
-    if (report.getValue() != "") 
+    //-- output report in JSON
+    if (report.getValue() != "")
     {
       //-- save the json report in memory first
       json jr;
-      get_report_json(jr, 
+      get_report_json(jr,
                        inputfile.getValue(),
                        lsFeatures,
                        snap_tol.getValue(),
@@ -618,7 +539,7 @@ int main(int argc, char* const argv[])
     else
       std::cout << "==> The validation report wasn't saved, use option '--report'." << std::endl;
 
-    //-- unittests 
+    //-- unittests
     if (unittests.getValue() == true)
       std::cout << "\n" << unit_test(lsFeatures, ioerrs) << std::endl;
 
@@ -629,7 +550,7 @@ int main(int argc, char* const argv[])
     }
     return(0);
   }
-  catch (TCLAP::ArgException &e) 
+  catch (TCLAP::ArgException &e)
   {
     std::cout << "ERROR: " << e.error() << " for arg " << e.argId() << std::endl;
     return(0);
@@ -942,4 +863,724 @@ void get_report_json(json& jr,
 }
 
 
+InputTypes get_input_type(std::string ifile, IOErrors& ioerrs)
+{
+  InputTypes inputtype = OTHER;
+  std::string extension = ifile.substr(ifile.find_last_of(".") + 1);
+  if ( (extension == "gml") || (extension == "GML") || (extension == "xml") || (extension == "XML") ) {
+    inputtype = GML;
+    ioerrs.set_input_file_type("GML");
+  }
+  else if ( (extension == "poly") || (extension == "POLY") ) {
+    inputtype = POLY;
+    ioerrs.set_input_file_type("POLY");
+  }
+  else if ( (extension == "json") || (extension == "JSON") ) {
+    inputtype = JSON;
+    ioerrs.set_input_file_type("CityJSON");
+  }
+  else if ( (extension == "jsonl") || (extension == "JSONL") ) {
+    inputtype = JSONL;
+    ioerrs.set_input_file_type("CityJSONSeq");
+  }
+  else if ( (extension == "obj") || (extension == "OBJ") ) {
+    inputtype = OBJ;
+    ioerrs.set_input_file_type("OBJ");
+  }
+  else if ( (extension == "off") || (extension == "OFF") ) {
+    inputtype = OFF;
+    ioerrs.set_input_file_type("OFF");
+  }
+  return inputtype;
+}
+
+
+Primitive3D get_primitive_type(InputTypes inputtype, std::string primitives)
+{
+  Primitive3D prim3d = SOLID;
+  if ( (inputtype == JSON) || (inputtype == JSONL) || (inputtype == GML) )
+    prim3d = ALL;
+  else if (primitives == "MultiSurface")
+    prim3d = MULTISURFACE;
+  else if (primitives == "CompositeSurface")
+    prim3d = COMPOSITESURFACE;
+  return prim3d;
+}
+
+
+//-- '*' matches any sequence of characters, '?' any one character
+bool match_wildcard(const char* pattern, const char* s)
+{
+  if (*pattern == '\0')
+    return (*s == '\0');
+  if (*pattern == '*')
+    return ( match_wildcard(pattern + 1, s) || ((*s != '\0') && match_wildcard(pattern, s + 1)) );
+  if ( (*s != '\0') && ((*pattern == '?') || (*pattern == *s)) )
+    return match_wildcard(pattern + 1, s + 1);
+  return false;
+}
+
+
+//-- the input is a batch if it's a directory (all the files with a supported
+//-- extension), a glob (eg "mydata/*.json"), or a list file (.txt or .lst
+//-- with one path per line; empty lines and lines starting with # are skipped)
+bool get_batch_inputs(std::string input, std::vector<std::string>& lsInputs)
+{
+  boost::filesystem::path inpath(input);
+  if (boost::filesystem::is_directory(inpath) == true)
+  {
+    IOErrors tmp;
+    for (auto& e : boost::filesystem::directory_iterator(inpath))
+    {
+      if ( (boost::filesystem::is_regular_file(e.path()) == true) &&
+           (get_input_type(e.path().string(), tmp) != OTHER) )
+        lsInputs.push_back(e.path().string());
+    }
+  }
+  else if (input.find_first_of("*?") != std::string::npos)
+  {
+    boost::filesystem::path dir = inpath.parent_path();
+    if (dir.empty() == true)
+      dir = ".";
+    std::string pattern = inpath.filename().string();
+    if (boost::filesystem::is_directory(dir) == true)
+    {
+      for (auto& e : boost::filesystem::directory_iterator(dir))
+      {
+        if ( (boost::filesystem::is_regular_file(e.path()) == true) &&
+             (match_wildcard(pattern.c_str(), e.path().filename().string().c_str()) == true) )
+          lsInputs.push_back(e.path().string());
+      }
+    }
+  }
+  else
+  {
+    std::string extension = boost::filesystem::extension(inpath);
+    if ( (extension != ".txt") && (extension != ".TXT") && (extension != ".lst") && (extension != ".LST") )
+      return false;
+    std::ifstream infile(input);
+    std::string l;
+    while (std::getline(infile, l))
+    {
+      l.erase(0, l.find_first_not_of(" \t\r"));
+      l.erase(l.find_last_not_of(" \t\r") + 1);
+      if ( (l.empty() == true) || (l[0] == '#') )
+        continue;
+      lsInputs.push_back(l);
+    }
+    return true;
+  }
+  std::sort(lsInputs.begin(), lsInputs.end());
+  return true;
+}
+
 
+void read_input(std::string ifile,
+                InputTypes inputtype,
+                Primitive3D prim3d,
+                const std::vector<std::string>& ishellfiles,
+                bool geom_is_sem_surfaces,
+                std::vector<Feature*>& lsFeatures,
+                ValidationContext& ctx)
+{
+  IOErrors& ioerrs = ctx.get_io_errors();
+  if (inputtype == GML)
+  {
+    try
+    {
+      read_file_gml(ifile,
+                    lsFeatures,
+                    ctx,
+                    geom_is_sem_surfaces);
+      if (ioerrs.has_errors() == true) {
+        std::cout << "Errors while reading the input file, aborting." << std::endl;
+        std::cout << ioerrs.get_report_text() << std::endl;
+      }
+      if (ishellfiles.size() > 0)
+      {
+        std::cout << "No inner shells allowed when GML file used as input." << std::endl;
+        ioerrs.add_error(901, "No inner shells allowed when GML file used as input.");
+      }
+    }
+    catch (int e)
+    {
+      if (e == 901)
+        ioerrs.add_error(901, "Invalid GML structure, or that particular construction of GML is not supported yet. Please report at https://github.com/tudelft3d/val3dity/issues and provide the file.");
+    }
+  }
+  else if (inputtype == JSON)
+  {
+    size_t nallocations = get_number_allocations();
+    read_file_cityjson(ifile,
+                       lsFeatures,
+                       ctx);
+#ifndef NDEBUG
+    std::clog << "Heap allocations while reading: " << (get_number_allocations() - nallocations) << std::endl;
+#endif
+    if (ioerrs.has_errors() == true) {
+      std::cout << "Errors while reading the input file, aborting." << std::endl;
+      std::cout << ioerrs.get_report_text() << std::endl;
+    }
+    if (ishellfiles.size() > 0)
+    {
+      std::cout << "No inner shells allowed when GML file used as input." << std::endl;
+      ioerrs.add_error(901, "No inner shells allowed when GML file used as input.");
+    }
+  }
+  else if (inputtype == JSONL)
+  {
+    std::vector<GeometryTemplate*> lsGTs;
+    read_file_cityjsonseq(ifile,
+                          ctx,
+                          lsGTs,
+                          [&](CityObject* co) { lsFeatures.push_back(co); });
+    if (ioerrs.has_errors() == true) {
+      std::cout << "Errors while reading the input file, aborting." << std::endl;
+      std::cout << ioerrs.get_report_text() << std::endl;
+    }
+    if (ishellfiles.size() > 0)
+    {
+      std::cout << "No inner shells allowed when GML file used as input." << std::endl;
+      ioerrs.add_error(901, "No inner shells allowed when GML file used as input.");
+    }
+  }
+  else if (inputtype == POLY)
+  {
+    GenericObject* o = new GenericObject("none");
+    Surface* sh = read_file_poly(ifile, 0, ctx);
+    if ( (ioerrs.has_errors() == false) & (prim3d == SOLID) )
+    {
+      Solid* s = new Solid;
+      s->set_oshell(sh);
+      int sid = 1;
+      for (auto ishellfile : ishellfiles)
+      {
+        Surface* sh = read_file_poly(ishellfile, sid, ctx);
+        if (ioerrs.has_errors() == false)
+        {
+          s->add_ishell(sh);
+          sid++;
+        }
+      }
+      if (ioerrs.has_errors() == false)
+        o->add_primitive(s);
+    }
+    else if ( (ioerrs.has_errors() == false) & (prim3d == COMPOSITESURFACE) )
+    {
+      CompositeSurface* cs = new CompositeSurface;
+      cs->set_surface(sh);
+      if (ioerrs.has_errors() == false)
+        o->add_primitive(cs);
+    }
+    else if ( (ioerrs.has_errors() == false) & (prim3d == MULTISURFACE) )
+    {
+      MultiSurface* ms = new MultiSurface;
+      ms->set_surface(sh);
+      if (ioerrs.has_errors() == false)
+        o->add_primitive(ms);
+    }
+    lsFeatures.push_back(o);
+  }
+  else if (inputtype == OFF)
+  {
+    GenericObject* o = new GenericObject("none");
+    Surface* sh = read_file_off(ifile, 0, ctx);
+    if ( (ioerrs.has_errors() == false) & (prim3d == SOLID) )
+    {
+      Solid* s = new Solid;
+      s->set_oshell(sh);
+      if (ioerrs.has_errors() == false)
+        o->add_primitive(s);
+    }
+    else if ( (ioerrs.has_errors() == false) & (prim3d == COMPOSITESURFACE) )
+    {
+      CompositeSurface* cs = new CompositeSurface;
+      cs->set_surface(sh);
+      if (ioerrs.has_errors() == false)
+        o->add_primitive(cs);
+    }
+    else if ( (ioerrs.has_errors() == false) & (prim3d == MULTISURFACE) )
+    {
+      MultiSurface* ms = new MultiSurface;
+      ms->set_surface(sh);
+      if (ioerrs.has_errors() == false)
+        o->add_primitive(ms);
+    }
+    lsFeatures.push_back(o);
+  }
+  else if (inputtype == OBJ)
+  {
+    read_file_obj(lsFeatures,
+                  ifile,
+                  prim3d,
+                  ctx);
+    if (ioerrs.has_errors() == true) {
+      std::cout << "Errors while reading the input file, aborting." << std::endl;
+      std::cout << ioerrs.get_report_text() << std::endl;
+    }
+    if (ishellfiles.size() > 0)
+    {
+      std::cout << "No inner shells allowed when GML file used as input." << std::endl;
+      ioerrs.add_error(901, "No inner shells allowed when GML file used as input.");
+    }
+  }
+}
+
+
+void print_parameters(Primitive3D prim3d, const ValidationContext& ctx)
+{
+  std::cout << "Primitive(s) validated: ";
+  if (prim3d == SOLID)
+    std::cout << "Solid" << std::endl;
+  else if (prim3d == MULTISURFACE)
+    std::cout << "MultiSurface" << std::endl;
+  else if (prim3d == COMPOSITESURFACE)
+    std::cout << "CompositeSurface" << std::endl;
+  else {
+    std::cout << "All" << std::endl;
+    std::cout << "(CityGML/CityJSON/IndoorGML have all their 3D primitives validated)" << std::endl;
+  }
+  //-- report on parameters used
+  std::cout << "Parameters used for validation:" << std::endl;
+  if (ctx.get_tol_snap() < 0)
+    std::cout << "   snap_tol"    << setw(22)  << "0.001" << std::endl;
+  else
+    std::cout << "   snap_tol"    << setw(22)  << ctx.get_tol_snap() << std::endl;
+  std::cout << "   planarity_d2p_tol"     << setw(13)  << ctx.get_tol_planarity_d2p() << std::endl;
+  std::cout << "   planarity_n_tol"       << setw(15) << ctx.get_tol_planarity_normals() << std::endl;
+  if (ctx.get_tol_overlap() < 1e-8)
+    std::cout << "   overlap_tol" << setw(19)  << "none" << std::endl;
+  else
+    std::cout << "   overlap_tol" << setw(19)  << ctx.get_tol_overlap() << std::endl;
+  std::cout << "   polygon_engine" << setw(16)  << ((ctx.get_polygon_engine() == ENGINE_NATIVE) ? "native" : "geos") << std::endl;
+  if (ctx.get_auto_orient() == true)
+    std::cout << "   auto_orient" << setw(19)  << "yes" << std::endl;
+  std::cout << std::endl;
+}
+
+
+void validate_features(std::vector<Feature*>& lsFeatures, const ValidationContext& ctx, bool verbose)
+{
+  if (TaskScheduler::get_number_threads() == 1)
+  {
+    int i = 1;
+    for (auto& f : lsFeatures)
+    {
+      if ( (i % 10 == 0) && (verbose == false) )
+        printProgressBar(100 * (i / double(lsFeatures.size())));
+      i++;
+      f->validate(ctx);
+    }
+  }
+  else
+  {
+    //-- each feature logs to its own buffer, these are written in order
+    //-- (in batch mode that buffer is already installed on clog)
+    std::streambuf* sinkCLOG = clog.rdbuf();
+    ThreadLogBuffer* threadlog = dynamic_cast<ThreadLogBuffer*>(sinkCLOG);
+    std::unique_ptr<ThreadLogBuffer> ownlog;
+    if (threadlog == NULL)
+    {
+      ownlog.reset(new ThreadLogBuffer(sinkCLOG));
+      threadlog = ownlog.get();
+      std::clog.rdbuf(threadlog);
+    }
+    OrderedLogWriter logs(*threadlog, lsFeatures.size());
+    std::mutex mprogress;
+    int done = 0;
+    TaskScheduler::parallel_for(lsFeatures.size(), [&](size_t k) {
+      std::string* prev = ThreadLogBuffer::capture(logs.get_slot(k));
+      lsFeatures[k]->validate(ctx);
+      ThreadLogBuffer::capture(prev);
+      logs.done(k);
+      std::lock_guard<std::mutex> lock(mprogress);
+      done++;
+      if ( (done % 10 == 0) && (verbose == false) )
+        printProgressBar(100 * (done / double(lsFeatures.size())));
+    });
+    std::clog.rdbuf(sinkCLOG);
+  }
+  if (verbose == false)
+    printProgressBar(100);
+}
+
+
+//-- the City Objects are validated by chunks while the file is read: one
+//-- chunk is filled (in another thread) while the previous one is validated. 
+//-- Only what is needed for the summary and the report is kept (ValidatedFeature)
+void validate_cityjson_stream(std::string ifile, InputTypes inputtype, std::vector<Feature*>& lsFeatures, ValidationContext& ctx, bool verbose)
+{
+  std::vector<GeometryTemplate*> lsGTs;
+  size_t chunksize = 16 * TaskScheduler::get_number_threads();
+  std::mutex mchunk;
+  std::condition_variable cvchunk;
+  std::vector<Feature*> ready;
+  bool finished = false;
+  auto hand_over = [&](std::vector<Feature*>& chunk, bool last)
+  {
+    std::unique_lock<std::mutex> lock(mchunk);
+    cvchunk.wait(lock, [&] { return ready.empty(); });
+    ready.swap(chunk);
+    finished = last;
+    cvchunk.notify_all();
+  };
+  std::future<void> reader = std::async(std::launch::async, [&]()
+  {
+    std::vector<Feature*> chunk;
+    auto process = [&](CityObject* co) 
+    {
+      chunk.push_back(co);
+      if (chunk.size() == chunksize)
+        hand_over(chunk, false);
+    };
+    try
+    {
+      if (inputtype == JSONL)
+        read_file_cityjsonseq(ifile, ctx, lsGTs, process);
+      else
+        read_file_cityjson_stream(ifile, ctx, lsGTs, process);
+    }
+    catch (...)
+    {
+      //-- the validation must not wait for a chunk that will never come
+      hand_over(chunk, true);
+      throw;
+    }
+    hand_over(chunk, true);
+  });
+  size_t nvalidated = 0;
+  while (true)
+  {
+    std::vector<Feature*> chunk;
+    bool last;
+    {
+      std::unique_lock<std::mutex> lock(mchunk);
+      cvchunk.wait(lock, [&] { return ( (ready.empty() == false) || (finished == true) ); });
+      chunk.swap(ready);
+      last = finished;
+      cvchunk.notify_all();
+    }
+    //-- no progress bar for each chunk, the number validated is printed
+    validate_features(chunk, ctx, true);
+    for (auto& f : chunk)
+    {
+      lsFeatures.push_back(new ValidatedFeature(f));
+      delete f;
+    }
+    nvalidated += chunk.size();
+    if ( (verbose == false) && (chunk.empty() == false) )
+      std::cout << "\r# City Objects validated: " << nvalidated << std::flush;
+    if (last == true)
+      break;
+  }
+  reader.get();
+  std::cout << std::endl;
+  for (auto& gt : lsGTs)
+    delete gt;
+}
+
+
+void write_off_files(std::vector<Feature*>& lsFeatures, std::string output_off)
+{
+  std::cout << std::endl << std::endl;
+  boost::filesystem::path outpath(output_off);
+  if (boost::filesystem::exists(outpath.parent_path()) == false)
+    std::cout << "Error OFF output: file " << outpath << " impossible to create, wrong path." << std::endl;
+  else {
+    if (boost::filesystem::exists(outpath) == false)
+      boost::filesystem::create_directory(outpath);
+    std::cout << "OFF files saved to: " << outpath << std::endl;
+    for (auto& f : lsFeatures) {
+      int noprim = 0;
+      for (auto& p : f->get_primitives()) {
+        std::string theid = f->get_id() + "." + std::to_string(noprim);
+        if (p->get_type() == SOLID)
+        {
+          boost::filesystem::path outfile = outpath / (theid + ".0.off");
+          std::ofstream o(outfile.string());
+          Solid* ts = dynamic_cast<Solid*>(p);
+          o << ts->get_off_representation(0) << std::endl;
+          o.close();
+          for (int i = 1; i <= ts->num_ishells(); i++)
+          {
+            outfile = outpath / (theid + "." + std::to_string(i) + ".off");
+            o.open(outfile.string());
+            o << ts->get_off_representation(1) << std::endl;
+            o.close();
+          }
+        }
+        else if (p->get_type() == MULTISURFACE)
+        {
+          boost::filesystem::path outfile = outpath / (theid + ".off");
+          std::ofstream o(outfile.string());
+          MultiSurface* ts = dynamic_cast<MultiSurface*>(p);
+          o << ts->get_off_representation() << std::endl;
+          o.close();
+        }
+        else if (p->get_type() == COMPOSITESURFACE)
+        {
+          boost::filesystem::path outfile = outpath / (theid + ".off");
+          std::ofstream o(outfile.string());
+          CompositeSurface* ts = dynamic_cast<CompositeSurface*>(p);
+          o << ts->get_off_representation() << std::endl;
+          o.close();
+        }
+        else {
+          std::cout << "OFF OUTPUT: these primitive types are not supported (yet). Sorry." << std::endl;
+        }
+        noprim++;
+      }
+    }
+  }
+  std::cout << std::endl;
+}
+
+
+void delete_features(std::vector<Feature*>& lsFeatures)
+{
+  //-- a GeometryTemplate can be used by several features: freed once at the end
+  std::set<Primitive*> templates;
+  for (auto& f : lsFeatures)
+    for (auto& p : f->get_primitives())
+      if (dynamic_cast<GeometryTemplate*>(p) != NULL)
+        templates.insert(p);
+  for (auto& f : lsFeatures)
+    delete f;
+  for (auto& p : templates)
+    delete p;
+  lsFeatures.clear();
+}
+
+
+//-- one file of a batch; it is read (in another thread) while the previous
+//-- one is validated, what is printed/logged while reading is kept here
+struct BatchItem
+{
+  BatchItem(std::string f, const ValidationContext& params)
+  : ifile(f),
+    ctx(params.get_tol_snap(), params.get_tol_planarity_d2p(), params.get_tol_planarity_normals(), params.get_tol_overlap())
+  {
+    ctx.set_polygon_engine(params.get_polygon_engine());
+    ctx.set_min_triangles_parallel(params.get_min_triangles_parallel());
+    ctx.set_auto_orient(params.get_auto_orient());
+  }
+  std::string           ifile;
+  ValidationContext     ctx;
+  std::vector<Feature*> lsFeatures;
+  std::string           out;
+  std::string           log;
+};
+
+
+void validate_batch(const std::vector<std::string>& lsInputs,
+                    const ValidationContext& params,
+                    std::string primitives,
+                    bool geom_is_sem_surfaces,
+                    std::string report,
+                    std::string output_off,
+                    bool unittests,
+                    bool verbose)
+{
+  std::cout << "Batch of " << lsInputs.size() << " file(s)" << std::endl;
+  std::cout << "Parameters used for validation:" << std::endl;
+  std::cout << "   snap_tol"    << setw(22)  << params.get_tol_snap() << std::endl;
+  std::cout << "   planarity_d2p_tol"     << setw(13)  << params.get_tol_planarity_d2p() << std::endl;
+  std::cout << "   planarity_n_tol"       << setw(15) << params.get_tol_planarity_normals() << std::endl;
+  if (params.get_tol_overlap() < 1e-8)
+    std::cout << "   overlap_tol" << setw(19)  << "none" << std::endl;
+  else
+    std::cout << "   overlap_tol" << setw(19)  << params.get_tol_overlap() << std::endl;
+  std::cout << "   polygon_engine" << setw(16)  << ((params.get_polygon_engine() == ENGINE_NATIVE) ? "native" : "geos") << std::endl;
+  if (params.get_auto_orient() == true)
+    std::cout << "   auto_orient" << setw(19)  << "yes" << std::endl;
+  std::cout << std::endl;
+
+  boost::system::error_code ec;
+  if ( (report != "") && (boost::filesystem::exists(report) == false) )
+  {
+    boost::filesystem::create_directories(report, ec);
+    if (ec) {
+      std::cout << "Error: directory " << report << " impossible to create, wrong path." << std::endl;
+      report = "";
+    }
+  }
+  if ( (output_off != "") && (boost::filesystem::exists(output_off) == false) )
+    boost::filesystem::create_directories(output_off, ec);
+
+  //-- what the reader of the next file prints and logs is held back until
+  //-- the current file is finished
+  std::streambuf* sinkCOUT = std::cout.rdbuf();
+  std::streambuf* sinkCLOG = std::clog.rdbuf();
+  ThreadLogBuffer threadout(sinkCOUT, OUT_CHANNEL);
+  ThreadLogBuffer threadlog(sinkCLOG, LOG_CHANNEL);
+  std::cout.rdbuf(&threadout);
+  std::clog.rdbuf(&threadlog);
+
+  auto read_one = [&](size_t k) -> BatchItem* {
+    BatchItem* item = new BatchItem(lsInputs[k], params);
+    std::string* prevout = ThreadLogBuffer::capture(&item->out, OUT_CHANNEL);
+    std::string* prevlog = ThreadLogBuffer::capture(&item->log, LOG_CHANNEL);
+    IOErrors& ioerrs = item->ctx.get_io_errors();
+    InputTypes inputtype = get_input_type(item->ifile, ioerrs);
+    if (inputtype == OTHER) {
+      std::stringstream ss;
+      ss << "Format of file " << item->ifile << " not supported (based on its extension).";
+      ioerrs.add_error(904, ss.str());
+      ioerrs.set_input_file_type("UNKNOWN");
+    }
+    else
+    {
+      //-- one broken file should not stop the whole batch
+      try
+      {
+        read_input(item->ifile,
+                   inputtype,
+                   get_primitive_type(inputtype, primitives),
+                   std::vector<std::string>(),
+                   geom_is_sem_surfaces,
+                   item->lsFeatures,
+                   item->ctx);
+      }
+      catch (std::exception& e)
+      {
+        ioerrs.add_error(901, e.what());
+      }
+    }
+    ThreadLogBuffer::capture(prevlog, LOG_CHANNEL);
+    ThreadLogBuffer::capture(prevout, OUT_CHANNEL);
+    return item;
+  };
+
+  json js;
+  js["type"] = "val3dity_batch_summary";
+  js["val3dity_version"] = VAL3DITY_VERSION;
+  js["parameters"]["snap_tol"] = params.get_tol_snap();
+  js["parameters"]["overlap_tol"] = params.get_tol_overlap();
+  js["parameters"]["planarity_d2p_tol"] = params.get_tol_planarity_d2p();
+  js["parameters"]["planarity_n_tol"] = params.get_tol_planarity_normals();
+  js["files"] = json::array();
+  std::set<std::string> reportnames;
+
+  std::future<BatchItem*> next;
+  if (lsInputs.empty() == false)
+    next = std::async(std::launch::async, read_one, 0);
+  for (size_t k = 0; k < lsInputs.size(); k++)
+  {
+    BatchItem* item = next.get();
+    if ( (k + 1) < lsInputs.size() )
+      next = std::async(std::launch::async, read_one, k + 1);
+    IOErrors& ioerrs = item->ctx.get_io_errors();
+    std::cout << "\n===== [" << (k + 1) << "/" << lsInputs.size() << "] " << item->ifile << " =====" << std::endl;
+    threadout.write(item->out);
+    threadlog.write(item->log);
+
+    if ( (item->lsFeatures.empty() == false) && (ioerrs.has_errors() == false) )
+    {
+      std::cout << "Validation of " << item->lsFeatures.size() << " feature(s):" << std::endl;
+      validate_features(item->lsFeatures, item->ctx, verbose);
+    }
+    if (ioerrs.has_specific_error(901) == true) {
+      std::cout << "ERROR 901" << std::endl;
+      delete_features(item->lsFeatures);
+    }
+    std::cout << "\n" << print_summary_validation(item->lsFeatures, ioerrs) << std::endl;
+
+    //-- one report per file, named after the file (and unique)
+    std::string name = boost::filesystem::path(item->ifile).stem().string();
+    if (reportnames.count(name) > 0)
+      name += "_" + std::to_string(k + 1);
+    reportnames.insert(name);
+    if (output_off != "")
+      write_off_files(item->lsFeatures, (boost::filesystem::path(output_off) / name).string());
+    json jr;
+    get_report_json(jr,
+                    item->ifile,
+                    item->lsFeatures,
+                    params.get_tol_snap(),
+                    params.get_tol_overlap(),
+                    params.get_tol_planarity_d2p(),
+                    params.get_tol_planarity_normals(),
+                    ioerrs);
+    json jf;
+    jf["input_file"] = jr["input_file"];
+    jf["input_file_type"] = jr["input_file_type"];
+    jf["validity"] = jr["validity"];
+    jf["all_errors"] = jr["all_errors"];
+    jf["features_overview"] = jr["features_overview"];
+    jf["primitives_overview"] = jr["primitives_overview"];
+    if (report != "")
+    {
+      boost::filesystem::path outpath = boost::filesystem::path(report) / (name + ".json");
+      write_report_json(jr, outpath.string());
+      jf["report"] = outpath.string();
+    }
+    js["files"].push_back(jf);
+
+    if (unittests == true)
+      std::cout << "\n" << unit_test(item->lsFeatures, ioerrs) << std::endl;
+    delete_features(item->lsFeatures);
+    delete item;
+  }
+  std::cout.rdbuf(sinkCOUT);
+  std::clog.rdbuf(sinkCLOG);
+
+  //-- aggregated summary of the batch
+  int nvalid = 0;
+  for (auto& jf : js["files"])
+    if (jf["validity"] == true)
+      nvalid++;
+  js["total_files"] = lsInputs.size();
+  js["valid_files"] = nvalid;
+  js["validity"] = (nvalid == static_cast<int>(lsInputs.size()));
+  std::cout << "\n" << print_summary_batch(js) << std::endl;
+  if (report != "")
+  {
+    boost::filesystem::path outpath = boost::filesystem::path(report) / "val3dity_summary.json";
+    std::ofstream o(outpath.string());
+    o << js.dump(2) << std::endl;
+    std::cout << "Summary of the batch saved to " << boost::filesystem::canonical(outpath) << std::endl;
+  }
+  else
+    std::cout << "==> The validation reports weren't saved, use option '--report' with a directory." << std::endl;
+}
+
+
+std::string print_summary_batch(json& js)
+{
+  std::stringstream ss;
+  int nfiles = js["files"].size();
+  int fInvalid = 0;
+  std::map<int,int> errors_files;
+  for (auto& jf : js["files"])
+  {
+    if (jf["validity"] == false)
+      fInvalid++;
+    for (int code : jf["all_errors"])
+      errors_files[code] += 1;
+  }
+  ss << "+++++++++++++++++ BATCH SUMMARY +++++++++++++++++" << std::endl;
+  ss << "Total # of files: " << setw(12) << nfiles << std::endl;
+  float percentage;
+  if (nfiles == 0)
+    percentage = 0;
+  else
+    percentage = 100 * (fInvalid / float(nfiles));
+  ss << "  # valid: " << setw(20) << nfiles - fInvalid;
+  ss << std::fixed << setprecision(1) << " (" << ((nfiles == 0) ? 0 : 100 - percentage) << "%)" << std::endl;
+  ss << "  # invalid: " << setw(18) << fInvalid;
+  ss << std::fixed << setprecision(1) << " (" << percentage << "%)" << std::endl;
+  if (errors_files.empty() == false)
+  {
+    ss << "+++++" << std::endl;
+    ss << "Errors present:" << std::endl;
+    for (auto e : errors_files)
+    {
+      ss << "  " << e.first << " -- " << ALL_ERRORS[e.first] << std::endl;
+      ss << setw(11) << e.second;
+      ss << " file(s)";
+      ss << std::endl;
+    }
+  }
+  ss << "+++++++++++++++++++++++++++++++++++++++++++++++" << std::endl;
+  return ss.str();
+}
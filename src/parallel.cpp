@@ -0,0 +1,348 @@
+/*
+  val3dity
+
+  Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of the Built Environment & Architecture
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+#include "parallel.h"
+
+#include <atomic>
+#include <thread>
+#include <deque>
+#include <memory>
+#include <condition_variable>
+
+namespace val3dity
+{
+
+thread_local std::string* ThreadLogBuffer::_captured[2] = {NULL, NULL};
+
+
+ThreadLogBuffer::ThreadLogBuffer(std::streambuf* sink, int channel)
+{
+  _sink = sink;
+  _channel = channel;
+}
+
+
+std::string* ThreadLogBuffer::capture(std::string* s, int channel)
+{
+  std::string* prev = _captured[channel];
+  _captured[channel] = s;
+  return prev;
+}
+
+
+void ThreadLogBuffer::write(const std::string& s)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _sink->sputn(s.c_str(), s.size());
+}
+
+
+int ThreadLogBuffer::overflow(int c)
+{
+  if (c == traits_type::eof())
+    return traits_type::not_eof(c);
+  char ch = traits_type::to_char_type(c);
+  if (_captured[_channel] != NULL)
+  {
+    _captured[_channel]->push_back(ch);
+    return c;
+  }
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _sink->sputc(ch);
+}
+
+
+std::streamsize ThreadLogBuffer::xsputn(const char* s, std::streamsize n)
+{
+  if (_captured[_channel] != NULL)
+  {
+    _captured[_channel]->append(s, n);
+    return n;
+  }
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _sink->sputn(s, n);
+}
+
+
+int ThreadLogBuffer::sync()
+{
+  //-- captured logs are flushed when they are written
+  if (_captured[_channel] != NULL)
+    return 0;
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _sink->pubsync();
+}
+
+
+OrderedLogWriter::OrderedLogWriter(ThreadLogBuffer& buf, size_t n)
+  : _buf(buf), _logs(n), _done(n, false), _next(0)
+{
+}
+
+
+std::string* OrderedLogWriter::get_slot(size_t i)
+{
+  return &(_logs[i]);
+}
+
+
+void OrderedLogWriter::done(size_t i)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _done[i] = true;
+  while ( (_next < _done.size()) && (_done[_next] == true) )
+  {
+    _buf.write(_logs[_next]);
+    std::string().swap(_logs[_next]);
+    _next++;
+  }
+}
+
+
+int get_number_threads(int requested)
+{
+  if (requested > 0)
+    return requested;
+  int n = static_cast<int>(std::thread::hardware_concurrency());
+  if (n < 1)
+    n = 1;
+  return n;
+}
+
+
+//-- one parallel_for() call: the function, the number of indices that are
+//-- not finished yet and the number of its tasks in the queues. The thread
+//-- waiting for the group sleeps on cv until one of them changes.
+struct TaskGroup
+{
+  const std::function<void(size_t)>*  f;
+  std::atomic<size_t>                 pending;
+  std::atomic<int>                    queued;
+  std::mutex                          mutex;
+  std::condition_variable             cv;
+};
+
+//-- a range [begin, end) of indices of one group
+struct Task
+{
+  TaskGroup*  group;
+  size_t      begin;
+  size_t      end;
+};
+
+struct WorkQueue
+{
+  std::mutex        mutex;
+  std::deque<Task>  tasks;
+};
+
+//-- queue 0 is used by the threads that are not workers (eg the main thread)
+static std::vector<std::unique_ptr<WorkQueue>>  _queues;
+static std::vector<std::thread>                 _workers;
+static std::atomic<int>                         _queued(0);
+static std::atomic<bool>                        _stopping(false);
+static std::mutex                               _sleep_mutex;
+static std::condition_variable                  _sleep_cv;
+static thread_local size_t                      _queue_id = 0;
+
+
+static void push_task(const Task& t)
+{
+  WorkQueue& q = *(_queues[_queue_id]);
+  {
+    std::lock_guard<std::mutex> lock(q.mutex);
+    q.tasks.push_back(t);
+  }
+  _queued++;
+  t.group->queued++;
+  { std::lock_guard<std::mutex> lock(t.group->mutex); }
+  t.group->cv.notify_all();
+  //-- taking the lock ensures a worker about to sleep sees the new task
+  { std::lock_guard<std::mutex> lock(_sleep_mutex); }
+  _sleep_cv.notify_one();
+}
+
+
+//-- takes a task from queue qi, from the back for the owner (the most recent
+//-- and smallest range) and from the front for the thieves. If group is
+//-- not NULL then only a task of that group is taken.
+static bool take_task(size_t qi, bool owner, TaskGroup* group, Task& t)
+{
+  WorkQueue& q = *(_queues[qi]);
+  std::lock_guard<std::mutex> lock(q.mutex);
+  if (q.tasks.empty() == true)
+    return false;
+  if (owner == true)
+  {
+    for (auto it = q.tasks.rbegin(); it != q.tasks.rend(); it++)
+    {
+      if ( (group == NULL) || (it->group == group) )
+      {
+        t = *it;
+        q.tasks.erase(std::next(it).base());
+        _queued--;
+        t.group->queued--;
+        return true;
+      }
+    }
+  }
+  else
+  {
+    for (auto it = q.tasks.begin(); it != q.tasks.end(); it++)
+    {
+      if ( (group == NULL) || (it->group == group) )
+      {
+        t = *it;
+        q.tasks.erase(it);
+        _queued--;
+        t.group->queued--;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+
+static bool find_task(TaskGroup* group, Task& t)
+{
+  if (take_task(_queue_id, true, group, t) == true)
+    return true;
+  for (size_t k = 1; k < _queues.size(); k++)
+  {
+    if (take_task((_queue_id + k) % _queues.size(), false, group, t) == true)
+      return true;
+  }
+  return false;
+}
+
+
+//-- the range is split in halves until one index is left, the other halves
+//-- are pushed on the queue of this thread and can be stolen
+static void run_task(Task t)
+{
+  while ( (t.end - t.begin) > 1 )
+  {
+    size_t mid = t.begin + ((t.end - t.begin) / 2);
+    push_task(Task{t.group, mid, t.end});
+    t.end = mid;
+  }
+  (*(t.group->f))(t.begin);
+  //-- last access to the group: under its lock, so that the waiting thread
+  //-- cannot return (and destroy it) before it is notified
+  std::lock_guard<std::mutex> lock(t.group->mutex);
+  if (--(t.group->pending) == 0)
+    t.group->cv.notify_all();
+}
+
+
+static void worker_loop(size_t id)
+{
+  _queue_id = id;
+  while (true)
+  {
+    Task t;
+    if (find_task(NULL, t) == true)
+    {
+      run_task(t);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(_sleep_mutex);
+    _sleep_cv.wait(lock, []{ return ( (_queued > 0) || (_stopping == true) ); });
+    if ( (_stopping == true) && (_queued == 0) )
+      return;
+  }
+}
+
+
+void TaskScheduler::start(int nthreads)
+{
+  stop();
+  if (nthreads < 1)
+    nthreads = 1;
+  for (int i = 0; i < nthreads; i++)
+    _queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+  _stopping = false;
+  for (int i = 1; i < nthreads; i++)
+    _workers.push_back(std::thread(worker_loop, size_t(i)));
+}
+
+
+void TaskScheduler::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(_sleep_mutex);
+    _stopping = true;
+  }
+  _sleep_cv.notify_all();
+  for (auto& t : _workers)
+    t.join();
+  _workers.clear();
+  _queues.clear();
+}
+
+
+int TaskScheduler::get_number_threads()
+{
+  return ( (_queues.size() > 1) ? static_cast<int>(_queues.size()) : 1 );
+}
+
+
+void TaskScheduler::parallel_for(size_t n, const std::function<void(size_t)>& f)
+{
+  if ( (_queues.size() <= 1) || (n <= 1) )
+  {
+    for (size_t i = 0; i < n; i++)
+      f(i);
+    return;
+  }
+  TaskGroup group;
+  group.f = &f;
+  group.pending = n;
+  group.queued = 0;
+  run_task(Task{&group, 0, n});
+  //-- while waiting, this thread helps with the tasks of this loop only; it
+  //-- thus never starts an unrelated (and perhaps long) task. When the last
+  //-- tasks are run by others it sleeps, until one of them pushes a new
+  //-- task of the loop (a half of its range) or the loop is finished
+  while (true)
+  {
+    Task t;
+    if (find_task(&group, t) == true)
+    {
+      run_task(t);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(group.mutex);
+    group.cv.wait(lock, [&group]{ return ( (group.pending == 0) || (group.queued > 0) ); });
+    if (group.pending == 0)
+      break;
+  }
+}
+
+} // namespace val3dity
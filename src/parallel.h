@@ -0,0 +1,108 @@
+/*
+  val3dity
+
+  Copyright (c) 2011-2020, 3D geoinformation research group, TU Delft
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of the Built Environment & Architecture
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+#ifndef __val3dity__parallel__
+#define __val3dity__parallel__
+
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <functional>
+
+namespace val3dity
+{
+
+//-- std::clog is shared by all the threads. This buffer is installed on it
+//-- so that each thread can capture what it logs in its own string; the
+//-- strings are then written to the real sink in the order of the features,
+//-- and the log is the same as with one thread.
+//-- In batch mode a second one is installed on std::cout (OUT_CHANNEL) to
+//-- hold back what is printed while the next file is read.
+enum { LOG_CHANNEL = 0, OUT_CHANNEL = 1 };
+
+class ThreadLogBuffer : public std::streambuf
+{
+public:
+  ThreadLogBuffer(std::streambuf* sink, int channel = LOG_CHANNEL);
+
+  //-- returns the previous capture string (NULL to stop capturing)
+  static std::string* capture(std::string* s, int channel = LOG_CHANNEL);
+  void              write(const std::string& s);
+
+protected:
+  int               overflow(int c);
+  std::streamsize   xsputn(const char* s, std::streamsize n);
+  int               sync();
+
+private:
+  std::streambuf*   _sink;
+  int               _channel;
+  std::mutex        _mutex;
+  static thread_local std::string* _captured[2];
+};
+
+
+//-- collects the logs of n tasks finishing in any order and writes
+//-- them in their index order as soon as possible
+class OrderedLogWriter
+{
+public:
+  OrderedLogWriter(ThreadLogBuffer& buf, size_t n);
+
+  std::string*      get_slot(size_t i);
+  void              done(size_t i);
+
+private:
+  ThreadLogBuffer&          _buf;
+  std::vector<std::string>  _logs;
+  std::vector<bool>         _done;
+  size_t                    _next;
+  std::mutex                _mutex;
+};
+
+
+//-- work-stealing scheduler shared by the whole process: each worker has
+//-- its own deque of tasks (ranges of indices) and steals from the others
+//-- when it has nothing to do. parallel_for() can be nested (features, and
+//-- the primitives of one feature); a thread waiting for its loop to finish
+//-- helps with the tasks of that loop only, and sleeps when there are none.
+class TaskScheduler
+{
+public:
+  static void   start(int nthreads);
+  static void   stop();
+  static int    get_number_threads();
+  static void   parallel_for(size_t n, const std::function<void(size_t)>& f);
+};
+
+int   get_number_threads(int requested);
+
+} // namespace val3dity
+
+#endif /* defined(__val3dity__parallel__) */
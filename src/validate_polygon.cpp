@@ -0,0 +1,355 @@
+/*
+  val3dity 
+
+  Copyright (c) 2011-2017, 3D geoinformation research group, TU Delft  
+
+  This file is part of val3dity.
+
+  val3dity is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  val3dity is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with val3dity.  If not, see <http://www.gnu.org/licenses/>.
+
+  For any information or further details about the use of val3dity, contact
+  Hugo Ledoux
+  <h.ledoux@tudelft.nl>
+  Faculty of Architecture & the Built Environment
+  Delft University of Technology
+  Julianalaan 134, Delft 2628BL, the Netherlands
+*/
+
+#include "validate_polygon.h"
+#include <algorithm>
+#include <numeric>
+#include <map>
+#include <set>
+#include <sstream>
+#include <iomanip>
+
+namespace val3dity
+{
+
+//-- one edge of a ring (from vertex i to vertex i+1), with its bbox
+struct RingEdge
+{
+  int     ring;
+  int     i;
+  double  xmin;
+  double  xmax;
+  double  ymin;
+  double  ymax;
+};
+
+typedef enum
+{
+  EDGES_DISJOINT  = 0,
+  EDGES_TOUCH     = 1, //-- only one common point, a vertex of one of them
+  EDGES_INTERSECT = 2, //-- proper crossing or collinear overlap
+} EdgesRelation;
+
+
+//-- only predicates are used, the touching point is always an input vertex
+static EdgesRelation relate_edges(const Point2& p, const Point2& q, const Point2& r, const Point2& s, Point2& touch)
+{
+  CGAL::Orientation o1 = CGAL::orientation(p, q, r);
+  CGAL::Orientation o2 = CGAL::orientation(p, q, s);
+  if ( (o1 == CGAL::COLLINEAR) && (o2 == CGAL::COLLINEAR) )
+  {
+    if ( (CGAL::collinear_are_strictly_ordered_along_line(p, r, q) == true) ||
+         (CGAL::collinear_are_strictly_ordered_along_line(p, s, q) == true) ||
+         (CGAL::collinear_are_strictly_ordered_along_line(r, p, s) == true) ||
+         (CGAL::collinear_are_strictly_ordered_along_line(r, q, s) == true) ||
+         ( (p == r) && (q == s) ) || 
+         ( (p == s) && (q == r) ) )
+      return EDGES_INTERSECT;
+    if ( (p == r) || (p == s) )
+    {
+      touch = p;
+      return EDGES_TOUCH;
+    }
+    if ( (q == r) || (q == s) )
+    {
+      touch = q;
+      return EDGES_TOUCH;
+    }
+    return EDGES_DISJOINT;
+  }
+  CGAL::Orientation o3 = CGAL::orientation(r, s, p);
+  CGAL::Orientation o4 = CGAL::orientation(r, s, q);
+  if ( (o1 != CGAL::COLLINEAR) && (o2 != CGAL::COLLINEAR) && (o3 != CGAL::COLLINEAR) && (o4 != CGAL::COLLINEAR) )
+  {
+    if ( (o1 != o2) && (o3 != o4) )
+      return EDGES_INTERSECT;
+    return EDGES_DISJOINT;
+  }
+  //-- one vertex is on the line of the other edge: touch if it is on the edge
+  if ( (o1 == CGAL::COLLINEAR) && (CGAL::collinear_are_ordered_along_line(p, r, q) == true) )
+    touch = r;
+  else if ( (o2 == CGAL::COLLINEAR) && (CGAL::collinear_are_ordered_along_line(p, s, q) == true) )
+    touch = s;
+  else if ( (o3 == CGAL::COLLINEAR) && (CGAL::collinear_are_ordered_along_line(r, p, s) == true) )
+    touch = p;
+  else if ( (o4 == CGAL::COLLINEAR) && (CGAL::collinear_are_ordered_along_line(r, q, s) == true) )
+    touch = q;
+  else
+    return EDGES_DISJOINT;
+  return EDGES_TOUCH;
+}
+
+
+//-- same vertices in the same cyclic order, in either direction
+static bool are_rings_duplicated(const Polygon& a, const Polygon& b)
+{
+  if (a.size() != b.size())
+    return false;
+  auto it = std::find(b.vertices_begin(), b.vertices_end(), a[0]);
+  if (it == b.vertices_end())
+    return false;
+  size_t n = a.size();
+  size_t start = it - b.vertices_begin();
+  bool forward = true;
+  bool backward = true;
+  for (size_t k = 0; k < n; k++)
+  {
+    if (a[k] != b[(start + k) % n])
+      forward = false;
+    if (a[k] != b[(start + n - k) % n])
+      backward = false;
+  }
+  return (forward || backward);
+}
+
+
+//-- where are the vertices of the ring a wrt the ring b (both simple)
+static void locate_ring(const Polygon& a, const Polygon& b, int& inside, int& outside)
+{
+  inside = 0;
+  outside = 0;
+  for (auto it = a.vertices_begin(); it != a.vertices_end(); it++)
+  {
+    CGAL::Bounded_side side = b.bounded_side(*it);
+    if (side == CGAL::ON_BOUNDED_SIDE)
+      inside++;
+    else if (side == CGAL::ON_UNBOUNDED_SIDE)
+      outside++;
+  }
+}
+
+
+static int find_root(std::vector<int>& parents, int i)
+{
+  while (parents[i] != i)
+  {
+    parents[i] = parents[parents[i]];
+    i = parents[i];
+  }
+  return i;
+}
+
+
+static std::string ring_name(int ring)
+{
+  std::stringstream ss;
+  if (ring == 0)
+    ss << "outer ring";
+  else
+    ss << "inner ring #" << ring;
+  return ss.str();
+}
+
+
+static void add_error(std::vector<Error>& lsErrors, int code, const std::string& info)
+{
+  Error e;
+  e.errorcode = code;
+  e.info1 = info;
+  e.info2 = "";
+  lsErrors.push_back(e);
+}
+
+
+bool validate_polygon_native(const std::vector<Polygon>& lsRings, std::vector<Error>& lsErrors)
+{
+  int nrings = static_cast<int>(lsRings.size());
+  //-- 1. all the edges, swept along x: only those whose bbox overlap are tested
+  std::vector<RingEdge> edges;
+  for (int r = 0; r < nrings; r++)
+  {
+    int n = static_cast<int>(lsRings[r].size());
+    for (int i = 0; i < n; i++)
+    {
+      const Point2& p = lsRings[r][i];
+      const Point2& q = lsRings[r][(i + 1) % n];
+      RingEdge e;
+      e.ring = r;
+      e.i = i;
+      e.xmin = std::min(p.x(), q.x());
+      e.xmax = std::max(p.x(), q.x());
+      e.ymin = std::min(p.y(), q.y());
+      e.ymax = std::max(p.y(), q.y());
+      edges.push_back(e);
+    }
+  }
+  std::sort(edges.begin(), edges.end(), [](const RingEdge& a, const RingEdge& b) { return a.xmin < b.xmin; });
+  std::vector<bool> selfintersecting(nrings, false);
+  int intersecting[2] = {-1, -1};
+  //-- the rings touching at each point (rings of different ids only)
+  std::map<Point2, std::set<int> > touches;
+  std::vector<int> active;
+  for (int k = 0; k < static_cast<int>(edges.size()); k++)
+  {
+    const RingEdge& e = edges[k];
+    active.erase(std::remove_if(active.begin(), active.end(), 
+                                [&](int a) { return edges[a].xmax < e.xmin; }), 
+                 active.end());
+    for (auto& a : active)
+    {
+      const RingEdge& f = edges[a];
+      if ( (f.ymax < e.ymin) || (f.ymin > e.ymax) )
+        continue;
+      const Polygon& re = lsRings[e.ring];
+      const Polygon& rf = lsRings[f.ring];
+      int ne = static_cast<int>(re.size());
+      int nf = static_cast<int>(rf.size());
+      Point2 touch;
+      EdgesRelation rel = relate_edges(re[e.i], re[(e.i + 1) % ne], rf[f.i], rf[(f.i + 1) % nf], touch);
+      if (rel == EDGES_DISJOINT)
+        continue;
+      if (e.ring == f.ring)
+      {
+        //-- consecutive edges share a vertex, that's all they may share
+        int d = std::abs(e.i - f.i);
+        bool consecutive = ( (d == 1) || (d == ne - 1) );
+        if ( (rel == EDGES_INTERSECT) || (consecutive == false) )
+          selfintersecting[e.ring] = true;
+      }
+      else if (rel == EDGES_INTERSECT)
+      {
+        if (intersecting[0] == -1)
+        {
+          intersecting[0] = std::min(e.ring, f.ring);
+          intersecting[1] = std::max(e.ring, f.ring);
+        }
+      }
+      else
+      {
+        touches[touch].insert(e.ring);
+        touches[touch].insert(f.ring);
+      }
+    }
+    active.push_back(k);
+  }
+  //-- 104: each ring must be simple
+  bool isvalid = true;
+  for (int r = 0; r < nrings; r++)
+  {
+    if (selfintersecting[r] == true)
+    {
+      add_error(lsErrors, 104, ring_name(r) + " self-intersects or is collapsed to a line");
+      isvalid = false;
+    }
+  }
+  if (isvalid == false)
+    return false;
+  //-- 208: orientation of oring != irings
+  CGAL::Orientation ooring = lsRings[0].orientation();
+  for (int r = 1; r < nrings; r++)
+  {
+    if (lsRings[r].orientation() == ooring)
+    {
+      add_error(lsErrors, 208, "same orientation for outer and inner rings");
+      return false;
+    }
+  }
+  //-- 202: duplicated rings (they also overlap, thus tested before 201)
+  std::vector<CGAL::Bbox_2> bboxes;
+  for (auto& each : lsRings)
+    bboxes.push_back(each.bbox());
+  for (int r = 0; r < nrings; r++)
+  {
+    for (int s = r + 1; s < nrings; s++)
+    {
+      if ( (bboxes[r] == bboxes[s]) && (are_rings_duplicated(lsRings[r], lsRings[s]) == true) )
+      {
+        add_error(lsErrors, 202, ring_name(r) + " and " + ring_name(s) + " are duplicated");
+        return false;
+      }
+    }
+  }
+  //-- 201: rings crossing or sharing a segment
+  if (intersecting[0] != -1)
+  {
+    add_error(lsErrors, 201, ring_name(intersecting[0]) + " and " + ring_name(intersecting[1]) + " intersect");
+    return false;
+  }
+  //-- 206: each iring inside the oring (a vertex on each side means they cross)
+  for (int r = 1; r < nrings; r++)
+  {
+    int inside, outside;
+    locate_ring(lsRings[r], lsRings[0], inside, outside);
+    if ( (inside > 0) && (outside > 0) )
+    {
+      add_error(lsErrors, 201, ring_name(0) + " and " + ring_name(r) + " intersect");
+      return false;
+    }
+    if (outside > 0)
+    {
+      add_error(lsErrors, 206, ring_name(r) + " lies outside the outer ring");
+      return false;
+    }
+  }
+  //-- 207: irings not nested
+  for (int r = 1; r < nrings; r++)
+  {
+    for (int s = 1; s < nrings; s++)
+    {
+      if ( (r == s) || (CGAL::do_overlap(bboxes[r], bboxes[s]) == false) )
+        continue;
+      int inside, outside;
+      locate_ring(lsRings[r], lsRings[s], inside, outside);
+      if ( (inside > 0) && (outside > 0) )
+      {
+        add_error(lsErrors, 201, ring_name(r) + " and " + ring_name(s) + " intersect");
+        return false;
+      }
+      if (inside > 0)
+      {
+        add_error(lsErrors, 207, ring_name(r) + " is inside " + ring_name(s));
+        return false;
+      }
+    }
+  }
+  //-- 205: the rings and their touching points form a graph, the interior 
+  //-- is disconnected if there's a cycle (eg an iring touching twice the oring)
+  std::vector<int> parents(nrings + touches.size());
+  std::iota(parents.begin(), parents.end(), 0);
+  int node = nrings;
+  for (auto& t : touches)
+  {
+    for (auto& r : t.second)
+    {
+      int a = find_root(parents, r);
+      int b = find_root(parents, node);
+      if (a == b)
+      {
+        std::stringstream ss;
+        ss << "rings touch in more than one point, one is at (" << std::setprecision(15) << t.first.x() << " " << t.first.y() << ")";
+        add_error(lsErrors, 205, ss.str());
+        return false;
+      }
+      parents[a] = b;
+    }
+    node++;
+  }
+  return true;
+}
+
+} // namespace val3dity
@@ -137,6 +137,11 @@ bool are_cells_interior_disconnected_with_aabb(std::vector<std::tuple<std::strin
   }
   CGAL::box_self_intersection_d( aabbs.begin(), aabbs.end(), Report_intersections(lsNefs, lsCellIDs, lsErrors, errorcode_to_assign, count));
   std::clog << "Total AABB tests: " << count << std::endl;
+  if (tol_overlap > 0)
+  {
+    for (auto each : lsNefs)
+      delete each;
+  }
   if (lsErrors.size() > n)
     return false;
   else
@@ -242,12 +247,18 @@ int are_primitives_adjacent(Primitive* p1,
     //-- 1. erode the nefs
     Nef_polyhedron* ne1 = erode_nef_polyhedron(n1, tol_overlap);
     Nef_polyhedron* ne2 = erode_nef_polyhedron(n2, tol_overlap);
-    if (ne1->interior() * ne2->interior() != emptynef)
+    bool overlap = (ne1->interior() * ne2->interior() != emptynef);
+    delete ne1;
+    delete ne2;
+    if (overlap == true)
       return 0;
     //-- 2. dilate the Nefs
     Nef_polyhedron* nd1 = dilate_nef_polyhedron(n1, tol_overlap);
     Nef_polyhedron* nd2 = dilate_nef_polyhedron(n2, tol_overlap);
-    if (nd1->interior() * nd2->interior() == emptynef)
+    bool touch = (nd1->interior() * nd2->interior() != emptynef);
+    delete nd1;
+    delete nd2;
+    if (touch == false)
       return 0;
     return 1;
   }
@@ -27,41 +27,13 @@
 */
 
 #include "Surface.h"
-#include <CGAL/intersections.h>
-#include <CGAL/IO/Polyhedron_iostream.h>
-#include <CGAL/intersections.h>
-#include <CGAL/Polyhedron_incremental_builder_3.h>
-
-#include <set>
-#include <list>
 
 namespace val3dity
 {
 
-template <class HDS>
-class ConstructShell : public CGAL::Modifier_base<HDS> {
-  std::vector< std::vector<int*> > *faces;
-  std::vector<Point3> *lsPts;
-  int _width;
-  Surface* sh;
-public:
-  bool isValid;
-  ConstructShell(std::vector< std::vector<int*> > *faces, std::vector<Point3> *lsPts, Surface* sh)
-    :faces(faces), lsPts(lsPts), sh(sh), isValid(true), _width(static_cast<int>(lsPts->size()))
-  {
-  }
-  void operator()( HDS& hds);
-  void construct_faces_order_given(CGAL::Polyhedron_incremental_builder_3<HDS>& B);
-  int m2a(int m, int n);
-  void construct_faces_flip_when_possible(CGAL::Polyhedron_incremental_builder_3<HDS>& B);
-  bool try_to_add_face(CGAL::Polyhedron_incremental_builder_3<HDS>& B, std::list<int*>& trFaces, bool* halfedges, bool bMustBeConnected);
-  bool is_connected(int* tr, bool* halfedges);
-  void add_one_face(CGAL::Polyhedron_incremental_builder_3<HDS>& B, int i0, int i1, int i2, std::string faceID) ;
-};
-
-
-CgalPolyhedron*   construct_CgalPolyhedron_incremental(std::vector< std::vector<int*> > *lsTr, std::vector<Point3> *lsPts, Surface* sh);
-CgalPolyhedron*   construct_CgalPolyhedron_batch(const std::vector< std::vector<int*> >&lsTr, const std::vector<Point3>& lsPts);
-bool              check_global_orientation_normals(CgalPolyhedron* p, bool bOuter);
+//-- the triangles must have passed Surface::precheck_combinatorics(); only the 
+//-- vertices used by them are added. NULL if one triangle cannot be added
+CgalMesh*   construct_CgalMesh(const std::vector<TriangleIds>& lsTr, const std::vector<Point3>& lsPts);
+bool        check_global_orientation_normals(const CgalMesh* m, bool bOuter);
 
 } // namespace val3dity
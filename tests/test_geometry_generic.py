@@ -10,6 +10,7 @@ thus a different format is used, and the test is still here.
 
 import pytest
 import os.path
+import json
 
 
 #------------------------------------------------------------------------ Data
@@ -146,6 +147,30 @@ def data_208(request, dir_geometry_generic):
     return(file_path)
 
 
+@pytest.fixture(scope="module",
+                params=[("104.poly", [104]),
+                        ("104_1.poly", [104]),
+                        ("104_2.poly", [104]),
+                        ("104_3.poly", [104]),
+                        ("104_4.poly", [104]),
+                        ("201.poly", [201]),
+                        ("201_1.poly", [201]),
+                        ("201_2.poly", [201]),
+                        ("202.poly", [202]),
+                        ("205.poly", [205]),
+                        ("206.poly", [206]),
+                        ("207.poly", [207]),
+                        ("207_1.poly", [207]),
+                        ("208.poly", [208]),
+                        ("204_valid_1.poly", [])])
+def data_polygon_engine(request, dir_geometry_generic):
+    file_path = os.path.abspath(
+        os.path.join(
+            dir_geometry_generic,
+            request.param[0]))
+    return(file_path, request.param[1])
+
+
 @pytest.fixture(scope="module",
                 params=["301.poly",
                         "301_1.poly"])
@@ -233,6 +258,24 @@ def data_307_1(request, dir_geometry_generic):
             request.param))
     return(file_path)
 
+@pytest.fixture(scope="module",
+                params=["307_2.poly"])
+def data_307_2(request, dir_geometry_generic):
+    file_path = os.path.abspath(
+        os.path.join(
+            dir_geometry_generic,
+            request.param))
+    return(file_path)
+
+@pytest.fixture(scope="module",
+                params=["307_3.poly"])
+def data_307_3(request, dir_geometry_generic):
+    file_path = os.path.abspath(
+        os.path.join(
+            dir_geometry_generic,
+            request.param))
+    return(file_path)
+
 @pytest.fixture(scope="module",
                 params=["401.poly",
                         "401_1.poly",
@@ -363,6 +406,12 @@ def test_208(validate, data_208, solid):
     error = validate(data_208, options=solid)
     assert(error == [208])
 
+def test_polygon_engine_native(validate, data_polygon_engine, solid):
+    """The native engine reports the same errors as GEOS"""
+    file_path, codes = data_polygon_engine
+    error = validate(file_path, options=solid + ["--polygon_engine", "native"])
+    assert(error == codes)
+
 def test_301(validate, data_301, solid):
     error = validate(data_301, options=solid)
     assert(error == [301])
@@ -371,6 +420,16 @@ def test_302(validate, data_302, solid):
     error = validate(data_302, options=solid)
     assert(error == [302])
 
+def test_302_hole(val3dity, validate_full, dir_geometry_generic, solid, tmp_path):
+    """The hole (the bottom face of the cube) is reported with its boundary"""
+    file_path = os.path.join(dir_geometry_generic, "302.poly")
+    report = tmp_path / "report.json"
+    command = [val3dity] + solid + [file_path, "--report", str(report)]
+    out, err = validate_full(command)
+    errors = json.loads(report.read_text())["features"][0]["primitives"][0]["errors"]
+    assert([e["code"] for e in errors] == [302])
+    assert(errors[0]["info"].endswith("boundary of 4 edges, length 4"))
+
 def test_303(validate, data_303, solid):
     error = validate(data_303, options=solid)
     assert(error == [303])
@@ -383,6 +442,15 @@ def test_305(validate, data_305, solid):
     error = validate(data_305, options=solid)
     assert(error == [305])
 
+def test_305_face_id(val3dity, validate_full, dir_geometry_generic, solid, tmp_path):
+    """The face reported is the one not in the largest component (the 1st)"""
+    file_path = os.path.join(dir_geometry_generic, "305.poly")
+    report = tmp_path / "report.json"
+    command = [val3dity] + solid + [file_path, "--report", str(report)]
+    out, err = validate_full(command)
+    errors = json.loads(report.read_text())["features"][0]["primitives"][0]["errors"]
+    assert([(e["code"], e["id"]) for e in errors] == [(305, "1")])
+
 def test_306(validate, data_306, solid):
     error = validate(data_306, options=solid)
     assert(error == [306])
@@ -396,6 +464,20 @@ def test_307_1(validate, data_307_1, solid):
     error = validate(data_307_1, options=solid)
     assert(error == [307])
 
+def test_307_2(validate, data_307_2, solid):
+    error = validate(data_307_2, options=solid)
+    assert(error == [307])
+
+def test_307_2_auto_orient(validate, data_307_2, solid):
+    """The 2 flipped faces are reoriented like the first one"""
+    error = validate(data_307_2, options=solid + ["--auto_orient"])
+    assert(error == [])
+
+def test_307_3_auto_orient(validate, data_307_3, solid):
+    """The first face is the flipped one: it is flipped, not the 5 others"""
+    error = validate(data_307_3, options=solid + ["--auto_orient"])
+    assert(error == [])
+
 def test_401(validate, data_401, solid):
     error = validate(data_401, options=solid)
     assert(error == [401])
@@ -12,7 +12,8 @@ import re
                     ["--unittests", "--overlap_tol 1.0"],
                     ["--unittests", "--snap_tol 0.01"],
                     ["--unittests", "--planarity_n_tol 18.5"],
-                    ["--unittests", "--planarity_d2p_tol 0.5"]
+                    ["--unittests", "--planarity_d2p_tol 0.5"],
+                    ["--unittests", "--threads 4"]
                     ])
 def options_valid(request):
     return(request.param)
@@ -161,3 +162,27 @@ def test_version(val3dity, validate_full):
     out, err = validate_full(command)
     assert "version:" in out
     
+
+def test_batch(val3dity, validate_full, dir_valid, tmp_path):
+    """A directory is validated as a batch: one report per file and a summary"""
+    command = [val3dity, dir_valid, "--report", str(tmp_path)]
+    out, err = validate_full(command)
+    assert "BATCH SUMMARY" in out
+    assert (tmp_path / "val3dity_summary.json").exists()
+    assert (tmp_path / "multi_solid.json").exists()
+
+
+def test_stream(val3dity, validate_full, dir_valid):
+    """A CityJSON file is streamed and gives the same result"""
+    file_path = os.path.join(dir_valid, "multi_solid.json")
+    command = [val3dity, file_path, "--stream", "--unittests"]
+    out, err = validate_full(command)
+    assert "@VALID" in out
+
+
+def test_cityjsonseq(val3dity, validate_full, dir_valid):
+    """Each CityJSONFeature of a CityJSONSeq file is validated"""
+    file_path = os.path.join(dir_valid, "composite_solid.jsonl")
+    command = [val3dity, file_path, "--unittests"]
+    out, err = validate_full(command)
+    assert "@VALID" in out